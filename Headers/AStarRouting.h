@@ -0,0 +1,169 @@
+// DSA concept used = A* search with geographic and landmark (ALT) lower bounds
+
+#pragma once
+#include "Location.h"
+#include "SearchWorkspace.h"
+#include <vector>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+// Which edge attribute a route query minimises
+enum class RouteMetric { COST, DISTANCE };
+
+/*
+    Lower bounds used by A* for one metric, precomputed per frozen graph.
+
+    Geographic bound: h(v) = scale * chordKm(v, target), where chordKm is the
+    straight line through the earth between the two points (never longer than the
+    great-circle distance, and only a square root to evaluate). `scale` is the
+    largest factor for which no edge is shorter (in the metric) than its scaled
+    chord, which makes the bound consistent. If any routed node has no
+    coordinates, or some edge beats its straight line outright, the bound is off.
+
+    Landmark (ALT) bound: for a few landmark nodes L we store the exact metric
+    distance d(L, v) over every route, ignoring closures and loads. Closing routes
+    or filling them only makes real routes longer, so by the triangle inequality
+    |d(L, t) - d(L, v)| stays a valid lower bound for the rest of the run.
+    Routes are added in both directions with the same weights, so d(L, v) = d(v, L).
+
+    The A* heuristic is the larger of the two; if neither is available the query
+    degenerates to plain Dijkstra.
+*/
+class RoutingHeuristics {
+    RouteMetric metricType = RouteMetric::COST;
+    std::vector<int> weights;                 // per-edge weight in this metric
+    std::vector<double> x, y, z;              // per dense node, on a sphere of earth radius (km)
+    double scale = 0.0;                       // 0 = geographic bound disabled
+    std::vector<int> landmarks;               // dense node indices
+    std::vector<std::vector<int>> landmarkDist; // [landmark][node], INT_MAX = unreachable
+
+public:
+    // Distances are stored as integer metres-equivalents (x1000) so the search stays integral
+    static constexpr double DISTANCE_UNITS = 1000.0;
+
+    /*
+        Builds the weights and the geographic bound. `coordinateOf(node, lat, lon)`
+        fills in the position of a dense node and returns false if it has none.
+    */
+    template <typename Graph, typename CoordinateLookup>
+    void build(const Graph& g, RouteMetric metric, CoordinateLookup coordinateOf) {
+        metricType = metric;
+        landmarks.clear();
+        landmarkDist.clear();
+
+        int n = g.nodeCount();
+        int m = g.edgeCount();
+        weights.resize(m);
+        for (int e = 0; e < m; ++e) {
+            weights[e] = metric == RouteMetric::COST
+                ? g.cost[e]
+                : static_cast<int>(std::floor(g.distance[e] * DISTANCE_UNITS));
+        }
+
+        x.assign(n, 0.0);
+        y.assign(n, 0.0);
+        z.assign(n, 0.0);
+        bool haveCoordinates = true;
+        const double earthRadiusKm = 6371.0;
+        const double toRadians = 3.14159265358979323846 / 180.0;
+        for (int v = 0; v < n && haveCoordinates; ++v) {
+            double lat = 0.0, lon = 0.0;
+            haveCoordinates = coordinateOf(v, lat, lon);
+            x[v] = earthRadiusKm * std::cos(lat * toRadians) * std::cos(lon * toRadians);
+            y[v] = earthRadiusKm * std::cos(lat * toRadians) * std::sin(lon * toRadians);
+            z[v] = earthRadiusKm * std::sin(lat * toRadians);
+        }
+
+        scale = 0.0;
+        if (!haveCoordinates) return;
+        double best = INFINITY;
+        for (int u = 0; u < n; ++u) {
+            for (int e = g.rowStart[u]; e < g.rowStart[u + 1]; ++e) {
+                double straight = chordKm(u, g.to[e]);
+                if (straight <= 0.0) {
+                    if (weights[e] < 0) return;   // negative weights: no bound is safe
+                    continue;
+                }
+                best = std::min(best, weights[e] / straight);
+            }
+        }
+        // Shave off a hair so rounding can never push the bound above a real route
+        if (std::isfinite(best) && best > 0.0) scale = best * (1.0 - 1e-9);
+    }
+
+    /*
+        Picks `count` landmarks: the node with the most routes first, then
+        repeatedly the node farthest from all landmarks chosen so far.
+    */
+    template <typename Graph>
+    void selectLandmarks(const Graph& g, int count) {
+        landmarks.clear();
+        landmarkDist.clear();
+        int n = g.nodeCount();
+        if (n == 0 || count <= 0) return;
+
+        // View of the graph with every route usable, for the exact landmark distances
+        struct AllEdges {
+            const Graph& g;
+            const std::vector<int>& rowStart;
+            const std::vector<int>& to;
+            int nodeCount() const { return g.nodeCount(); }
+            bool canAddLoad(int, int) const { return true; }
+        } all{ g, g.rowStart, g.to };
+
+        int hub = 0;
+        for (int v = 1; v < n; ++v) {
+            if (g.rowStart[v + 1] - g.rowStart[v] > g.rowStart[hub + 1] - g.rowStart[hub]) hub = v;
+        }
+
+        std::vector<int> nearest(n, INT_MAX);   // distance to the closest landmark so far
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        int next = hub;
+        while (static_cast<int>(landmarks.size()) < count && next >= 0) {
+            runAStar(all, weights, ws, next, -1, 0, [](int) { return 0; });
+            landmarks.push_back(next);
+            landmarkDist.emplace_back(n);
+            std::vector<int>& d = landmarkDist.back();
+            for (int v = 0; v < n; ++v) {
+                d[v] = ws.distanceTo(v);
+                nearest[v] = std::min(nearest[v], d[v]);
+            }
+
+            // Farthest reachable node; prefer an unreached component if there is one
+            next = -1;
+            int farthest = -1;
+            for (int v = 0; v < n; ++v) {
+                if (nearest[v] == 0) continue;
+                int score = nearest[v];   // INT_MAX (unreached) wins
+                if (score > farthest) {
+                    farthest = score;
+                    next = v;
+                }
+            }
+        }
+    }
+
+    double chordKm(int a, int b) const {
+        double dx = x[a] - x[b], dy = y[a] - y[b], dz = z[a] - z[b];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    RouteMetric metric() const { return metricType; }
+    const std::vector<int>& edgeWeights() const { return weights; }
+    bool hasGeographicBound() const { return scale > 0.0; }
+    size_t landmarkCount() const { return landmarks.size(); }
+
+    // Consistent lower bound on the metric distance from v to target
+    int lowerBound(int v, int target) const {
+        int bound = 0;
+        if (scale > 0.0) {
+            bound = static_cast<int>(std::floor(scale * chordKm(v, target)));
+        }
+        for (const std::vector<int>& d : landmarkDist) {
+            if (d[v] == INT_MAX || d[target] == INT_MAX) continue;
+            bound = std::max(bound, std::abs(d[target] - d[v]));
+        }
+        return bound;
+    }
+};
@@ -0,0 +1,298 @@
+// DSA concept used = Column store in fixed-size chunks with per-chunk summaries (zone maps)
+
+#pragma once
+#include "ResourceTypeRegistry.h"
+#include "Utilities.h"
+#include <vector>
+#include <array>
+#include <map>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <atomic>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+/*
+    Append-only record of every allocation (source, target, type id, quantity,
+    time), stored column by column in chunks of CHUNK_ROWS rows.
+
+    Once a chunk is full it is sealed and never changes again. Each chunk keeps
+    a small summary (row count, time range, total quantity per type) so
+    aggregate queries can answer whole chunks from the summary and only scan
+    the columns of chunks that straddle the edge of a time window.
+
+    With spilling enabled, sealed chunks beyond the newest `maxResidentChunks`
+    are written to disk and their columns freed; only the summary stays in
+    memory. Queries that need the rows of a spilled chunk read it back just for
+    the duration of the scan.
+*/
+class AllocationLedger {
+public:
+    static constexpr size_t CHUNK_ROWS = 4096;
+
+    using TypeTotals = std::array<long long, MAX_RESOURCE_TYPES>;
+
+private:
+    struct Columns {
+        std::vector<std::int32_t> source;
+        std::vector<std::int32_t> target;
+        std::vector<ResourceTypeId> type;
+        std::vector<std::int32_t> quantity;
+        std::vector<Timestamp> time;
+
+        size_t size() const { return quantity.size(); }
+        void reserve(size_t n) {
+            source.reserve(n); target.reserve(n); type.reserve(n); quantity.reserve(n); time.reserve(n);
+        }
+    };
+
+    struct Chunk {
+        Columns columns;                    // empty while spilled
+        size_t rows = 0;
+        Timestamp minTime = INT64_MAX;
+        Timestamp maxTime = INT64_MIN;
+        TypeTotals typeTotals{};
+        std::string spillFile;              // non-empty once the columns live on disk
+    };
+
+    std::vector<Chunk> chunks;              // the last one is open for appends
+    size_t totalRows = 0;
+
+    std::string spillDirectory;             // empty = keep everything in memory
+    size_t maxResidentChunks = 0;
+    size_t nextToSpill = 0;                 // sealed chunks before this index are spilled (or tried)
+    std::string spillPrefix;                // "ledger_<pid>_<n>_": keeps ledgers sharing a directory apart
+
+    // Numbers the ledgers of this process; the pid tells processes apart
+    static std::string uniqueSpillPrefix() {
+        static std::atomic<unsigned> nextLedger{ 0 };
+#ifdef _WIN32
+        long pid = static_cast<long>(_getpid());
+#else
+        long pid = static_cast<long>(getpid());
+#endif
+        return "ledger_" + std::to_string(pid) + "_" + std::to_string(nextLedger++) + "_";
+    }
+
+    template <typename T>
+    static void writeColumn(std::ofstream& out, const std::vector<T>& column) {
+        out.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+    }
+
+    template <typename T>
+    static bool readColumn(std::ifstream& in, std::vector<T>& column, size_t rows) {
+        column.resize(rows);
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(column.data()), static_cast<std::streamsize>(rows * sizeof(T))));
+    }
+
+    // Writes a sealed chunk's columns to disk and frees them; false leaves it in memory
+    bool spill(size_t index) {
+        Chunk& c = chunks[index];
+        std::string path = spillDirectory + "/" + spillPrefix + "chunk_" + std::to_string(index) + ".bin";
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        writeColumn(out, c.columns.source);
+        writeColumn(out, c.columns.target);
+        writeColumn(out, c.columns.type);
+        writeColumn(out, c.columns.quantity);
+        writeColumn(out, c.columns.time);
+        out.close();
+        if (!out) {
+            std::remove(path.c_str());   // a partial file would never be cleaned up
+            return false;
+        }
+
+        c.spillFile = path;
+        c.columns = Columns();
+        return true;
+    }
+
+    void spillOldChunks() {
+        if (spillDirectory.empty()) return;
+        size_t sealed = chunks.empty() ? 0 : chunks.size() - 1;
+        while (nextToSpill + maxResidentChunks < sealed) {
+            spill(nextToSpill);
+            ++nextToSpill;
+        }
+    }
+
+    /*
+        Columns of chunk `index`, reading them back into `scratch` if the chunk
+        was spilled. Returns null if a spill file can no longer be read.
+    */
+    const Columns* columnsOf(size_t index, Columns& scratch) const {
+        const Chunk& c = chunks[index];
+        if (c.spillFile.empty()) return &c.columns;
+        std::ifstream in(c.spillFile, std::ios::binary);
+        if (!in.is_open()) return nullptr;
+        bool ok = readColumn(in, scratch.source, c.rows) && readColumn(in, scratch.target, c.rows) &&
+            readColumn(in, scratch.type, c.rows) && readColumn(in, scratch.quantity, c.rows) &&
+            readColumn(in, scratch.time, c.rows);
+        return ok ? &scratch : nullptr;
+    }
+
+    /*
+        Visits the rows with from <= time < to. `wholeChunk(chunk)` is offered
+        every chunk that lies entirely inside the window and returns true if it
+        handled the chunk from its summary; otherwise `row(columns, i)` is
+        called for each matching row.
+    */
+    template <typename WholeChunk, typename Row>
+    void scan(Timestamp from, Timestamp to, WholeChunk wholeChunk, Row row) const {
+        Columns scratch;
+        for (size_t index = 0; index < chunks.size(); ++index) {
+            const Chunk& c = chunks[index];
+            if (c.rows == 0 || c.maxTime < from || c.minTime >= to) continue;
+            if (c.minTime >= from && c.maxTime < to && wholeChunk(c)) continue;
+            const Columns* cols = columnsOf(index, scratch);
+            if (!cols) continue;
+            for (size_t i = 0; i < c.rows; ++i) {
+                if (cols->time[i] >= from && cols->time[i] < to) row(*cols, i);
+            }
+        }
+    }
+
+public:
+    AllocationLedger() : spillPrefix(uniqueSpillPrefix()) {}
+
+    ~AllocationLedger() {
+        for (const Chunk& c : chunks) {
+            if (!c.spillFile.empty()) std::remove(c.spillFile.c_str());
+        }
+    }
+
+    AllocationLedger(const AllocationLedger&) = delete;
+    AllocationLedger& operator=(const AllocationLedger&) = delete;
+
+    /*
+        Spills sealed chunks to files in `directory`, keeping only the newest
+        `residentChunks` sealed chunks in memory. File names carry a prefix unique
+        to this ledger, so several ledgers can share a directory. The files are
+        removed when the ledger is destroyed. An empty directory turns spilling
+        off for new chunks.
+    */
+    void enableSpill(const std::string& directory, size_t residentChunks) {
+        spillDirectory = directory;
+        maxResidentChunks = residentChunks;
+        spillOldChunks();
+    }
+
+    void append(int source, int target, ResourceTypeId type, int quantity, Timestamp time) {
+        if (chunks.empty() || chunks.back().rows == CHUNK_ROWS) {
+            chunks.emplace_back();
+            chunks.back().columns.reserve(CHUNK_ROWS);
+            spillOldChunks();
+        }
+        Chunk& c = chunks.back();
+        c.columns.source.push_back(source);
+        c.columns.target.push_back(target);
+        c.columns.type.push_back(type);
+        c.columns.quantity.push_back(quantity);
+        c.columns.time.push_back(time);
+        ++c.rows;
+        c.minTime = std::min(c.minTime, time);
+        c.maxTime = std::max(c.maxTime, time);
+        if (type < MAX_RESOURCE_TYPES) c.typeTotals[type] += quantity;
+        ++totalRows;
+    }
+
+    size_t size() const { return totalRows; }
+    bool empty() const { return totalRows == 0; }
+    size_t chunkCount() const { return chunks.size(); }
+
+    size_t spilledChunkCount() const {
+        size_t count = 0;
+        for (const Chunk& c : chunks) count += c.spillFile.empty() ? 0 : 1;
+        return count;
+    }
+
+    // Calls fn(source, target, type, quantity, time) for every row in insertion order
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        Columns scratch;
+        for (size_t index = 0; index < chunks.size(); ++index) {
+            const Columns* cols = columnsOf(index, scratch);
+            if (!cols) continue;
+            for (size_t i = 0; i < chunks[index].rows; ++i) {
+                fn(cols->source[i], cols->target[i], cols->type[i], cols->quantity[i], cols->time[i]);
+            }
+        }
+    }
+
+    /*
+        Calls fn(source, target, type, quantity, time) for the rows from
+        `firstRow` on, in insertion order. Earlier chunks are skipped without
+        being looked at, so reading only what was appended since the last
+        call costs O(new rows).
+    */
+    template <typename Fn>
+    void forEachFrom(size_t firstRow, Fn fn) const {
+        Columns scratch;
+        for (size_t index = firstRow / CHUNK_ROWS; index < chunks.size(); ++index) {
+            const Columns* cols = columnsOf(index, scratch);
+            if (!cols) continue;
+            size_t begin = index == firstRow / CHUNK_ROWS ? firstRow % CHUNK_ROWS : 0;
+            for (size_t i = begin; i < chunks[index].rows; ++i) {
+                fn(cols->source[i], cols->target[i], cols->type[i], cols->quantity[i], cols->time[i]);
+            }
+        }
+    }
+
+    // Total quantity allocated per resource type in [from, to)
+    TypeTotals totalsByType(Timestamp from = INT64_MIN, Timestamp to = INT64_MAX) const {
+        TypeTotals totals{};
+        scan(from, to,
+            [&](const Chunk& c) {
+                for (int t = 0; t < MAX_RESOURCE_TYPES; ++t) totals[t] += c.typeTotals[t];
+                return true;
+            },
+            [&](const Columns& cols, size_t i) {
+                if (cols.type[i] < MAX_RESOURCE_TYPES) totals[cols.type[i]] += cols.quantity[i];
+            });
+        return totals;
+    }
+
+    // Total quantity of one type in [from, to)
+    long long totalForType(ResourceTypeId type, Timestamp from = INT64_MIN, Timestamp to = INT64_MAX) const {
+        return type < MAX_RESOURCE_TYPES ? totalsByType(from, to)[type] : 0;
+    }
+
+    // Total quantity delivered to each target location in [from, to), ordered by location ID
+    std::map<int, long long> totalsByTarget(Timestamp from = INT64_MIN, Timestamp to = INT64_MAX) const {
+        std::map<int, long long> totals;
+        scan(from, to,
+            [](const Chunk&) { return false; },
+            [&](const Columns& cols, size_t i) { totals[cols.target[i]] += cols.quantity[i]; });
+        return totals;
+    }
+
+    /*
+        Total quantity per time bucket: element k covers
+        [from + k * bucket, from + (k + 1) * bucket) up to `to`.
+    */
+    std::vector<long long> totalsByWindow(Timestamp from, Timestamp to, Timestamp bucket) const {
+        if (bucket <= 0 || to <= from) return {};
+        std::vector<long long> totals(static_cast<size_t>((to - from + bucket - 1) / bucket), 0);
+        scan(from, to,
+            [&](const Chunk& c) {
+                // The whole chunk falls into one bucket: its totals answer it
+                if ((c.minTime - from) / bucket != (c.maxTime - from) / bucket) return false;
+                long long sum = 0;
+                for (long long q : c.typeTotals) sum += q;
+                totals[static_cast<size_t>((c.minTime - from) / bucket)] += sum;
+                return true;
+            },
+            [&](const Columns& cols, size_t i) {
+                totals[static_cast<size_t>((cols.time[i] - from) / bucket)] += cols.quantity[i];
+            });
+        return totals;
+    }
+};
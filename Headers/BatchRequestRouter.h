@@ -0,0 +1,81 @@
+#pragma once
+#include "TransportationNetwork.h"
+#include "PriorityRequestQueue.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// One request taken off the queue together with the route computed for it
+struct RoutedRequest {
+    Request request;
+    bool endpointsOperational = false;
+    std::vector<int> path;              // empty if no route was found
+    std::uint64_t networkVersion = 0;   // network version (snapshot) the route was computed on
+
+    explicit RoutedRequest(const Request& req) : request(req) {}
+};
+
+/*
+    Routing stage of the batched request pipeline.
+
+    routeNextBatch() drains the top `batchSize` requests in priority order and
+    computes their routes concurrently on the pool. The workers route on an
+    immutable NetworkSnapshot (with per-thread search workspaces), never on the
+    live network, so the network may keep changing while they run.
+
+    Commits then happen on the caller's thread in priority order, exactly like
+    the serial loop. If the network changed since a route was computed, the
+    route is discarded and recomputed at commit time (see routeIsCurrent).
+*/
+class BatchRequestRouter {
+    ThreadPool pool;
+    size_t batchSize;
+    std::vector<RoutedRequest> batch;   // slots are reused from batch to batch
+    size_t batchCount = 0;
+
+public:
+    BatchRequestRouter(size_t threadCount, size_t batchSize)
+        : pool(threadCount), batchSize(std::max<size_t>(1, batchSize)) {
+    }
+
+    size_t threadCount() const { return pool.size(); }
+
+    // Pops up to batchSize requests and routes them on the network's current snapshot
+    size_t routeNextBatch(PriorityRequestQueue& queue, const TransportationNetwork& network) {
+        return routeNextBatch(queue, network.snapshot());
+    }
+
+    // Pops up to batchSize requests and routes them on `snapshot`; returns how many were taken
+    size_t routeNextBatch(PriorityRequestQueue& queue, std::shared_ptr<const NetworkSnapshot> snapshot) {
+        batchCount = 0;
+        while (batchCount < batchSize && !queue.isEmpty()) {
+            const Request& top = queue.getTopRequest();
+            if (batchCount < batch.size()) batch[batchCount].request = top;
+            else batch.emplace_back(top);
+            queue.processTopRequest();
+            ++batchCount;
+        }
+
+        const NetworkSnapshot& view = *snapshot;
+        pool.parallelFor(batchCount, [&](size_t i) {
+            RoutedRequest& r = batch[i];
+            const Request& req = r.request;
+            r.networkVersion = view.version();
+            r.endpointsOperational = view.isLocationOperational(req.sourceLocationId) &&
+                view.isLocationOperational(req.targetLocationId);
+            r.path.clear();
+            if (r.endpointsOperational) {
+                view.findOptimalPath(req.sourceLocationId, req.targetLocationId, req.requiredQuantity, r.path);
+            }
+        });
+        return batchCount;
+    }
+
+    RoutedRequest& at(size_t i) { return batch[i]; }
+
+    // False if the network changed after the route was computed (it must be recomputed)
+    static bool routeIsCurrent(const RoutedRequest& r, const TransportationNetwork& network) {
+        return r.networkVersion == network.version();
+    }
+};
@@ -0,0 +1,190 @@
+// DSA concept used = Intrusive indexed set (members store their own slot; O(1) insert and swap-remove)
+
+#pragma once
+#include "CriticalLevelWatcher.h"
+#include "Resource.h"
+#include "Location.h"
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <algorithm>
+
+// One stock that is below its critical level
+struct CriticalAlert {
+    int locationId;          // CriticalLevelTracker::CENTRAL_STOCK for a resource's central stock
+    ResourceTypeId type;
+    int available;
+    int criticalLevel;
+};
+
+/*
+    Keeps the set of stocks that are currently below their critical level,
+    for central resources and for per-location thresholds alike.
+
+    Resource and Location compare their stock against the threshold on every
+    change and only call in here when it was crossed, so the set is maintained
+    incrementally: listing the alerts costs O(alerts), not O(inventory).
+    Each watched stock remembers its own position in the list (alertSlot), so
+    joining and leaving the set are O(1) without any lookup.
+
+    A crossing re-reads the current stock under the tracker's lock rather than
+    trusting the direction it was reported with, so concurrent allocations on
+    several threads still leave the set exact. Transition callbacks run on the
+    thread whose change caused them, after the lock is released; register them
+    before allocations start on other threads.
+
+    Watched objects point back at the tracker. It detaches them when destroyed,
+    so they must still exist at that point (ResourceManager owns the tracker,
+    the resources, and references a network that outlives it).
+*/
+class CriticalLevelTracker : public CriticalLevelWatcher {
+public:
+    static constexpr int CENTRAL_STOCK = -1;
+
+    // `below` is true when the stock just dropped below the level, false when it recovered
+    using TransitionCallback = std::function<void(const CriticalAlert& alert, bool below)>;
+
+private:
+    struct Entry {
+        Resource* resource;      // central stock, or null for a location slot
+        Location* location;
+        ResourceTypeId type;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Entry> alerts;               // the stocks below their level, in no particular order
+    size_t centralAlerts = 0;                // how many of them are central stocks
+    std::vector<Resource*> watchedResources;
+    std::vector<Location*> watchedLocations;
+    std::vector<TransitionCallback> callbacks;
+
+    static int& slotOf(const Entry& e) {
+        return e.resource ? e.resource->alertSlot : e.location->alertSlots[e.type];
+    }
+
+    static CriticalAlert alertFor(const Entry& e) {
+        if (e.resource) {
+            return { CENTRAL_STOCK, e.type, e.resource->getAvailableQuantity(), e.resource->criticalLevel };
+        }
+        return { e.location->id, e.type, e.location->getAvailableQuantity(e.type), e.location->criticalLevels[e.type] };
+    }
+
+    static bool isBelow(const Entry& e) {
+        if (e.resource) return e.resource->isBelowCriticalLevel();
+        int level = e.location->criticalLevels[e.type];
+        return level > 0 && e.location->getAvailableQuantity(e.type) < level;
+    }
+
+    // Brings the entry's membership in line with its current stock; true if it changed
+    bool refreshLocked(const Entry& e, bool& below) {
+        int& slot = slotOf(e);
+        below = isBelow(e);
+        if (below == (slot >= 0)) return false;
+        if (below) {
+            slot = static_cast<int>(alerts.size());
+            alerts.push_back(e);
+            if (e.resource) ++centralAlerts;
+        }
+        else {
+            // Swap-remove: the last entry takes the freed position
+            int at = slot;
+            slot = -1;
+            if (e.resource) --centralAlerts;
+            if (at != static_cast<int>(alerts.size()) - 1) {
+                alerts[at] = alerts.back();
+                slotOf(alerts[at]) = at;
+            }
+            alerts.pop_back();
+        }
+        return true;
+    }
+
+    void refresh(const Entry& e) {
+        bool below = false;
+        CriticalAlert alert;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!refreshLocked(e, below)) return;
+            if (callbacks.empty()) return;
+            alert = alertFor(e);
+        }
+        for (const TransitionCallback& callback : callbacks) callback(alert, below);
+    }
+
+public:
+    CriticalLevelTracker() = default;
+
+    ~CriticalLevelTracker() {
+        for (Resource* r : watchedResources) {
+            r->watcher = nullptr;
+            r->alertSlot = -1;
+        }
+        for (Location* loc : watchedLocations) {
+            loc->watcher = nullptr;
+            loc->alertSlots.fill(-1);
+        }
+    }
+
+    CriticalLevelTracker(const CriticalLevelTracker&) = delete;
+    CriticalLevelTracker& operator=(const CriticalLevelTracker&) = delete;
+
+    // Starts tracking a resource's central stock against resource.criticalLevel
+    void watch(Resource& resource) {
+        if (resource.watcher == this) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            resource.watcher = this;
+            watchedResources.push_back(&resource);
+        }
+        refresh({ &resource, nullptr, resource.typeId });
+    }
+
+    // Sets the critical level of `type` at `location` (0 removes it) and tracks it
+    void watch(Location& location, ResourceTypeId type, int criticalLevel) {
+        if (type >= MAX_RESOURCE_TYPES) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (location.watcher != this) {
+                location.watcher = this;
+                watchedLocations.push_back(&location);
+            }
+            location.criticalLevels[type] = std::max(0, criticalLevel);
+        }
+        refresh({ nullptr, &location, type });
+    }
+
+    void onTransition(TransitionCallback callback) { callbacks.push_back(std::move(callback)); }
+
+    size_t alertCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return alerts.size();
+    }
+
+    // Central resources below their level
+    size_t centralAlertCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return centralAlerts;
+    }
+
+    // Current alerts: central stocks first, then by location ID and type
+    std::vector<CriticalAlert> currentAlerts() const {
+        std::vector<CriticalAlert> out;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            out.reserve(alerts.size());
+            for (const Entry& e : alerts) out.push_back(alertFor(e));
+        }
+        std::sort(out.begin(), out.end(), [](const CriticalAlert& a, const CriticalAlert& b) {
+            return a.locationId != b.locationId ? a.locationId < b.locationId : a.type < b.type;
+        });
+        return out;
+    }
+
+    void resourceChanged(Resource& resource) override {
+        refresh({ &resource, nullptr, resource.typeId });
+    }
+
+    void locationStockChanged(Location& location, ResourceTypeId type) override {
+        refresh({ nullptr, &location, type });
+    }
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "ResourceTypeRegistry.h"
+
+class Resource;
+class Location;
+
+/*
+    Told by Resource and Location whenever a stock change crosses the critical
+    level (in either direction). Only crossings are reported, so ordinary
+    allocations above or below the threshold cost one comparison.
+    Implemented by CriticalLevelTracker.
+*/
+class CriticalLevelWatcher {
+public:
+    virtual ~CriticalLevelWatcher() = default;
+
+    // The central stock of `resource` crossed resource.criticalLevel
+    virtual void resourceChanged(Resource& resource) = 0;
+
+    // The stock of `type` at `location` crossed location.criticalLevels[type]
+    virtual void locationStockChanged(Location& location, ResourceTypeId type) = 0;
+};
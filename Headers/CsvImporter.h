@@ -0,0 +1,318 @@
+#pragma once
+#include "CsvReader.h"
+#include "TransportationNetwork.h"
+#include "PriorityRequestQueue.h"
+#include "Request.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+
+// Outcome of one CSV import
+struct CsvImportStats {
+    long long rows = 0;                 // data rows read (header and blank lines not counted)
+    long long imported = 0;
+    long long skipped = 0;              // malformed or duplicate rows
+    std::vector<std::string> errors;    // "line N: reason" for the first skipped rows
+};
+
+/*
+    Streams the daily CSV exports (sites, road segments, incoming requests)
+    into a network and a request queue.
+
+    Every file starts with a header row; columns are found by name (any order,
+    any case, unknown columns ignored):
+        locations: id, latitude|lat, longitude|lon|lng, [name], [operational], [capacity]
+        routes:    from|source, to|target, capacity, cost, [operational], [distance], [type], [load]
+        requests:  source, target, resource|type, quantity, priority, [id]
+    Files are read through CsvReader in fixed-size chunks, so memory depends on
+    what is imported, not on the file size. Routes and requests are handed over
+    in batches (TransportationNetwork::addRoutes, PriorityRequestQueue::addRequests),
+    and when the file size is known the containers are reserved once for the
+    number of rows extrapolated from the first batch. Malformed rows are
+    skipped and reported in the stats; a missing required column or an
+    unreadable file throws std::runtime_error.
+*/
+class CsvImporter {
+public:
+    static constexpr size_t DEFAULT_BATCH_ROWS = 65536;
+    static constexpr size_t MAX_REPORTED_ERRORS = 20;
+
+private:
+    TransportationNetwork& network;
+    size_t batchRows;
+
+    // Index of the first header column matching one of `names`, or -1
+    static int columnOf(const CsvReader& header, std::initializer_list<const char*> names) {
+        for (size_t i = 0; i < header.fieldCount(); ++i) {
+            std::string_view title = csv_parse::trim(header.field(i));
+            for (const char* name : names) {
+                if (csv_parse::equalsWord(title, name)) return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    static int requireColumn(const CsvReader& header, const char* file, std::initializer_list<const char*> names) {
+        int column = columnOf(header, names);
+        if (column < 0) throw std::runtime_error(std::string(file) + " CSV: missing column '" + *names.begin() + "'");
+        return column;
+    }
+
+    // Reads the header row (the first non-blank line); false if the input is empty
+    static bool readHeader(CsvReader& reader) {
+        while (reader.next()) {
+            if (!reader.isBlank()) return true;
+        }
+        return false;
+    }
+
+    static void skip(CsvImportStats& stats, const CsvReader& reader, const char* reason) {
+        ++stats.skipped;
+        if (stats.errors.size() < MAX_REPORTED_ERRORS) {
+            stats.errors.push_back("line " + std::to_string(reader.lineNumber()) + ": " + reason);
+        }
+    }
+
+    // Rows still to come in a file of totalBytes, going by the bytes per row read so far
+    static size_t remainingRows(const CsvReader& reader, long long rowsSoFar, std::uint64_t totalBytes) {
+        if (totalBytes == 0 || rowsSoFar <= 0 || reader.bytesConsumed() == 0) return 0;
+        double perRow = static_cast<double>(reader.bytesConsumed()) / rowsSoFar;
+        double left = (static_cast<double>(totalBytes) - reader.bytesConsumed()) / perRow;
+        return left > 0 ? static_cast<size_t>(left * 1.05) + 1 : 0;
+    }
+
+    static std::ifstream openFile(const std::string& filename, std::uint64_t& size) {
+        std::ifstream in(filename, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) throw std::runtime_error("Cannot open CSV file '" + filename + "'");
+        size = static_cast<std::uint64_t>(in.tellg());
+        in.seekg(0);
+        return in;
+    }
+
+    static bool optionalBool(const CsvReader& row, int column, bool fallback, bool& out) {
+        if (column < 0 || csv_parse::trim(row.field(column)).empty()) { out = fallback; return true; }
+        return csv_parse::parseBool(row.field(column), out);
+    }
+
+    static bool optionalInt(const CsvReader& row, int column, int fallback, int& out) {
+        if (column < 0 || csv_parse::trim(row.field(column)).empty()) { out = fallback; return true; }
+        return csv_parse::parseInt(row.field(column), out);
+    }
+
+    static bool optionalDouble(const CsvReader& row, int column, double fallback, double& out) {
+        if (column < 0 || csv_parse::trim(row.field(column)).empty()) { out = fallback; return true; }
+        return csv_parse::parseDouble(row.field(column), out);
+    }
+
+public:
+    explicit CsvImporter(TransportationNetwork& network, size_t batchRows = DEFAULT_BATCH_ROWS)
+        : network(network), batchRows(std::max<size_t>(1, batchRows)) {
+    }
+
+    // Adds every location of a sites export; a location ID that already exists is skipped
+    CsvImportStats importLocations(std::istream& in, std::uint64_t totalBytes = 0) {
+        CsvImportStats stats;
+        CsvReader reader(in);
+        if (!readHeader(reader)) return stats;
+        const int idColumn = requireColumn(reader, "locations", { "id" });
+        const int latColumn = requireColumn(reader, "locations", { "latitude", "lat" });
+        const int lonColumn = requireColumn(reader, "locations", { "longitude", "lon", "lng" });
+        const int nameColumn = columnOf(reader, { "name" });
+        const int openColumn = columnOf(reader, { "operational", "open" });
+        const int capacityColumn = columnOf(reader, { "capacity", "max_capacity" });
+
+        bool reserved = false;
+        while (reader.next()) {
+            if (reader.isBlank()) continue;
+            ++stats.rows;
+            int id = 0, capacity = 0;
+            double lat = 0, lon = 0;
+            bool operational = true;
+            if (!csv_parse::parseInt(reader.field(idColumn), id)) { skip(stats, reader, "bad id"); continue; }
+            if (!csv_parse::parseDouble(reader.field(latColumn), lat) || lat < -90 || lat > 90 ||
+                !csv_parse::parseDouble(reader.field(lonColumn), lon) || lon < -180 || lon > 180) {
+                skip(stats, reader, "bad coordinates");
+                continue;
+            }
+            if (!optionalBool(reader, openColumn, true, operational)) { skip(stats, reader, "bad operational flag"); continue; }
+            if (!optionalInt(reader, capacityColumn, 1000, capacity)) { skip(stats, reader, "bad capacity"); continue; }
+            if (network.getLocation(id)) { skip(stats, reader, "duplicate location id"); continue; }
+
+            std::string name = nameColumn >= 0 ? std::string(csv_parse::trim(reader.field(nameColumn))) : std::string();
+            if (name.empty()) name = "Location " + std::to_string(id);
+            network.addLocation(Location(id, name, lat, lon, operational, capacity));
+            ++stats.imported;
+
+            if (!reserved && stats.rows == static_cast<long long>(batchRows)) {
+                network.reserve(remainingRows(reader, stats.rows, totalBytes), 0);
+                reserved = true;
+            }
+        }
+        return stats;
+    }
+
+    // Adds every route of a road segments export (both directions, like addEdge)
+    CsvImportStats importRoutes(std::istream& in, std::uint64_t totalBytes = 0) {
+        CsvImportStats stats;
+        CsvReader reader(in);
+        if (!readHeader(reader)) return stats;
+        const int fromColumn = requireColumn(reader, "routes", { "from", "source" });
+        const int toColumn = requireColumn(reader, "routes", { "to", "target" });
+        const int capacityColumn = requireColumn(reader, "routes", { "capacity" });
+        const int costColumn = requireColumn(reader, "routes", { "cost" });
+        const int openColumn = columnOf(reader, { "operational", "open" });
+        const int distanceColumn = columnOf(reader, { "distance" });
+        const int typeColumn = columnOf(reader, { "type", "route_type" });
+        const int loadColumn = columnOf(reader, { "load", "current_load" });
+
+        std::vector<RouteSpec> batch;
+        batch.reserve(batchRows);
+        // Rows without a type, whether the cell is empty or the column is missing, are roads
+        const std::string defaultType = "road";
+        const RouteTypeId defaultTypeId = network.routeTypeId(defaultType);
+        std::string lastType = defaultType;
+        RouteTypeId lastTypeId = defaultTypeId;
+        bool reserved = false;
+
+        while (reader.next()) {
+            if (reader.isBlank()) continue;
+            ++stats.rows;
+            RouteSpec r{ 0, 0, 0, 0, true, 1.0, defaultTypeId, -1 };
+            if (!csv_parse::parseInt(reader.field(fromColumn), r.from) ||
+                !csv_parse::parseInt(reader.field(toColumn), r.to)) {
+                skip(stats, reader, "bad endpoint");
+                continue;
+            }
+            if (!csv_parse::parseInt(reader.field(capacityColumn), r.capacity) || r.capacity < 0) {
+                skip(stats, reader, "bad capacity");
+                continue;
+            }
+            if (!csv_parse::parseInt(reader.field(costColumn), r.cost) || r.cost < 0) { skip(stats, reader, "bad cost"); continue; }
+            if (!optionalBool(reader, openColumn, true, r.operational)) { skip(stats, reader, "bad operational flag"); continue; }
+            if (!optionalDouble(reader, distanceColumn, 1.0, r.distance)) { skip(stats, reader, "bad distance"); continue; }
+            if (!optionalInt(reader, loadColumn, -1, r.load)) { skip(stats, reader, "bad load"); continue; }
+            if (typeColumn >= 0) {
+                std::string_view type = csv_parse::trim(reader.field(typeColumn));
+                if (!type.empty() && type != lastType) {
+                    lastType.assign(type.data(), type.size());
+                    try {
+                        lastTypeId = network.routeTypeId(lastType);
+                    }
+                    catch (const std::runtime_error&) {
+                        lastType = defaultType;
+                        lastTypeId = defaultTypeId;
+                        skip(stats, reader, "too many route types");
+                        continue;
+                    }
+                }
+                r.routeType = type.empty() ? defaultTypeId : lastTypeId;
+            }
+
+            batch.push_back(r);
+            ++stats.imported;
+            if (batch.size() == batchRows) {
+                if (!reserved) {
+                    network.reserve(0, remainingRows(reader, stats.rows, totalBytes));
+                    reserved = true;
+                }
+                network.addRoutes(batch);
+                batch.clear();
+            }
+        }
+        network.addRoutes(batch);
+        return stats;
+    }
+
+    /*
+        Bulk-loads an incoming requests export into `queue`. Rows without an id
+        (or without an id column) are numbered from nextRequestId, which is left
+        past the largest id seen.
+    */
+    CsvImportStats importRequests(std::istream& in, PriorityRequestQueue& queue, int& nextRequestId,
+        std::uint64_t totalBytes = 0) {
+        CsvImportStats stats;
+        CsvReader reader(in);
+        if (!readHeader(reader)) return stats;
+        const int sourceColumn = requireColumn(reader, "requests", { "source", "from" });
+        const int targetColumn = requireColumn(reader, "requests", { "target", "to" });
+        const int resourceColumn = requireColumn(reader, "requests", { "resource", "type" });
+        const int quantityColumn = requireColumn(reader, "requests", { "quantity", "qty" });
+        const int priorityColumn = requireColumn(reader, "requests", { "priority" });
+        const int idColumn = columnOf(reader, { "id", "request_id" });
+
+        std::vector<Request> batch;
+        batch.reserve(batchRows);
+        std::string lastResource;
+        ResourceTypeId lastResourceId = INVALID_RESOURCE_TYPE;
+        bool reserved = false;
+
+        while (reader.next()) {
+            if (reader.isBlank()) continue;
+            ++stats.rows;
+            int id = -1, source = 0, target = 0, quantity = 0, priority = 0;
+            if (!optionalInt(reader, idColumn, -1, id)) { skip(stats, reader, "bad id"); continue; }
+            if (!csv_parse::parseInt(reader.field(sourceColumn), source) ||
+                !csv_parse::parseInt(reader.field(targetColumn), target)) {
+                skip(stats, reader, "bad endpoint");
+                continue;
+            }
+            if (!csv_parse::parseInt(reader.field(quantityColumn), quantity) || quantity <= 0) {
+                skip(stats, reader, "bad quantity");
+                continue;
+            }
+            if (!csv_parse::parseInt(reader.field(priorityColumn), priority)) { skip(stats, reader, "bad priority"); continue; }
+            std::string_view resource = csv_parse::trim(reader.field(resourceColumn));
+            if (resource.empty()) { skip(stats, reader, "missing resource"); continue; }
+            if (resource != lastResource || lastResourceId == INVALID_RESOURCE_TYPE) {
+                lastResource.assign(resource.data(), resource.size());
+                try {
+                    lastResourceId = internResourceType(lastResource);
+                }
+                catch (const std::runtime_error&) {
+                    lastResourceId = INVALID_RESOURCE_TYPE;
+                    skip(stats, reader, "too many resource types");
+                    continue;
+                }
+            }
+
+            if (id < 0) id = nextRequestId++;
+            else nextRequestId = std::max(nextRequestId, id + 1);
+            batch.emplace_back(id, source, target, lastResourceId, quantity, priority);
+            ++stats.imported;
+            if (batch.size() == batchRows) {
+                if (!reserved) {
+                    queue.reserve(remainingRows(reader, stats.rows, totalBytes) + batch.size());
+                    reserved = true;
+                }
+                queue.addRequests(batch);
+                batch.clear();
+            }
+        }
+        queue.addRequests(batch);
+        return stats;
+    }
+
+    // File versions of the above; they know the file size and reserve for it
+    CsvImportStats importLocations(const std::string& filename) {
+        std::uint64_t size = 0;
+        std::ifstream in = openFile(filename, size);
+        return importLocations(in, size);
+    }
+
+    CsvImportStats importRoutes(const std::string& filename) {
+        std::uint64_t size = 0;
+        std::ifstream in = openFile(filename, size);
+        return importRoutes(in, size);
+    }
+
+    CsvImportStats importRequests(const std::string& filename, PriorityRequestQueue& queue, int& nextRequestId) {
+        std::uint64_t size = 0;
+        std::ifstream in = openFile(filename, size);
+        return importRequests(in, queue, nextRequestId, size);
+    }
+};
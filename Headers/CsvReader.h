@@ -0,0 +1,240 @@
+// DSA concept used = Chunked streaming parser over a sliding buffer
+
+#pragma once
+#include <istream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+
+/*
+    Field parsers for CSV imports. They work on string_views into the reader's
+    buffer, skip surrounding blanks and reject trailing garbage. Decimal
+    numbers with up to 19 significant digits and a small exponent (which is
+    every coordinate, distance and cost in our exports) are converted exactly
+    with one multiplication or division by a power of ten; anything else goes
+    through strtod.
+*/
+namespace csv_parse {
+    inline std::string_view trim(std::string_view s) {
+        size_t first = 0, last = s.size();
+        while (first < last && (s[first] == ' ' || s[first] == '\t')) ++first;
+        while (last > first && (s[last - 1] == ' ' || s[last - 1] == '\t')) --last;
+        return s.substr(first, last - first);
+    }
+
+    inline bool parseInt(std::string_view s, int& out) {
+        s = trim(s);
+        size_t i = 0;
+        bool negative = false;
+        if (i < s.size() && (s[i] == '-' || s[i] == '+')) negative = s[i++] == '-';
+        if (i == s.size()) return false;
+        long long value = 0;
+        for (; i < s.size(); ++i) {
+            char c = s[i];
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + (c - '0');
+            if (value > static_cast<long long>(INT_MAX) + 1) return false;
+        }
+        if (negative) value = -value;
+        if (value > INT_MAX || value < INT_MIN) return false;
+        out = static_cast<int>(value);
+        return true;
+    }
+
+    inline bool parseDouble(std::string_view s, double& out) {
+        static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        s = trim(s);
+        size_t i = 0;
+        bool negative = false;
+        if (i < s.size() && (s[i] == '-' || s[i] == '+')) negative = s[i++] == '-';
+
+        std::uint64_t mantissa = 0;
+        int digits = 0, exponent = 0;
+        bool anyDigit = false;
+        // Significant digits go into the mantissa; past 19 of them only the exponent moves
+        for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i, anyDigit = true) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (s[i] - '0');
+                if (mantissa) ++digits;
+            }
+            else ++exponent;
+        }
+        if (i < s.size() && s[i] == '.') {
+            for (++i; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i, anyDigit = true) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + (s[i] - '0');
+                    if (mantissa) ++digits;
+                    --exponent;
+                }
+            }
+        }
+        if (!anyDigit) return false;
+        if (i < s.size() && (s[i] == 'e' || s[i] == 'E')) {
+            ++i;
+            bool negativeExponent = false;
+            if (i < s.size() && (s[i] == '-' || s[i] == '+')) negativeExponent = s[i++] == '-';
+            size_t exponentStart = i;
+            int e = 0;
+            for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i) {
+                if (e < 100000) e = e * 10 + (s[i] - '0');
+            }
+            if (i == exponentStart) return false;
+            exponent += negativeExponent ? -e : e;
+        }
+        if (i != s.size()) return false;
+
+        if (mantissa < (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+            double value = static_cast<double>(mantissa);
+            value = exponent < 0 ? value / POW10[-exponent] : value * POW10[exponent];
+            out = negative ? -value : value;
+            return true;
+        }
+        // Rare slow path: let the C library round it
+        std::string copy(s);
+        char* end = nullptr;
+        out = std::strtod(copy.c_str(), &end);
+        return end == copy.c_str() + copy.size();
+    }
+
+    // ASCII case-insensitive comparison with a lowercase word
+    inline bool equalsWord(std::string_view s, std::string_view lowerWord) {
+        if (s.size() != lowerWord.size()) return false;
+        for (size_t i = 0; i < s.size(); ++i) {
+            char c = s[i] >= 'A' && s[i] <= 'Z' ? static_cast<char>(s[i] - 'A' + 'a') : s[i];
+            if (c != lowerWord[i]) return false;
+        }
+        return true;
+    }
+
+    // 1/0, true/false, yes/no, open/closed (any case)
+    inline bool parseBool(std::string_view s, bool& out) {
+        s = trim(s);
+        if (s == "1" || equalsWord(s, "true") || equalsWord(s, "yes") || equalsWord(s, "open")) { out = true; return true; }
+        if (s == "0" || equalsWord(s, "false") || equalsWord(s, "no") || equalsWord(s, "closed")) { out = false; return true; }
+        return false;
+    }
+}
+
+/*
+    Reads CSV records (RFC 4180: quoted fields, "" escapes, embedded commas and
+    line breaks, \n or \r\n line ends) from a stream in fixed-size chunks.
+    Memory stays at one chunk plus the longest record, however large the
+    file: the buffer only grows when a single record does not fit into it.
+    Fields are string_views into the buffer, valid until the next call to
+    next(); quoted fields are unescaped in place.
+*/
+class CsvReader {
+    std::istream& in;
+    std::vector<char> buffer;
+    size_t begin = 0;           // start of the unread data
+    size_t end = 0;             // end of the data read so far
+    bool inputDone = false;
+    char delimiter;
+    std::vector<std::string_view> fields;
+    long long line = 0;         // line the current record starts on (1-based)
+    long long nextLine = 1;
+    std::uint64_t consumed = 0; // bytes of all records returned so far
+
+    // Moves the unread tail to the front and fills the rest of the buffer
+    void refill() {
+        if (begin > 0) {
+            std::copy(buffer.begin() + begin, buffer.begin() + end, buffer.begin());
+            end -= begin;
+            begin = 0;
+        }
+        if (end == buffer.size()) buffer.resize(buffer.size() * 2);   // one record is bigger than the buffer
+        in.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+        end += static_cast<size_t>(in.gcount());
+        if (!in) inputDone = true;
+    }
+
+    // Finds the end of the record at `begin` (quote-aware); false if it is not all in the buffer yet
+    bool findRecordEnd(size_t& recordEnd, size_t& next, long long& lineBreaks) const {
+        bool quoted = false;
+        lineBreaks = 0;
+        for (size_t i = begin; i < end; ++i) {
+            char c = buffer[i];
+            if (c == '"') quoted = !quoted;
+            else if (c == '\n') {
+                ++lineBreaks;
+                if (!quoted) {
+                    recordEnd = i;
+                    next = i + 1;
+                    return true;
+                }
+            }
+        }
+        if (!inputDone) return false;
+        recordEnd = next = end;   // last record without a line break
+        return true;
+    }
+
+    // Splits buffer[first, last) into fields, unescaping quoted ones in place
+    void split(size_t first, size_t last) {
+        fields.clear();
+        if (last > first && buffer[last - 1] == '\r') --last;
+        char* p = buffer.data() + first;
+        char* stop = buffer.data() + last;
+        while (true) {
+            if (p < stop && *p == '"') {
+                char* out = ++p;
+                char* start = out;
+                while (p < stop) {
+                    if (*p == '"') {
+                        if (p + 1 < stop && p[1] == '"') { *out++ = '"'; p += 2; continue; }
+                        ++p;
+                        break;
+                    }
+                    *out++ = *p++;
+                }
+                fields.emplace_back(start, static_cast<size_t>(out - start));
+                while (p < stop && *p != delimiter) ++p;   // stray text after the closing quote is dropped
+            }
+            else {
+                char* start = p;
+                while (p < stop && *p != delimiter) ++p;
+                fields.emplace_back(start, static_cast<size_t>(p - start));
+            }
+            if (p >= stop) break;
+            ++p;   // skip the delimiter; a trailing one yields an empty last field
+        }
+    }
+
+public:
+    explicit CsvReader(std::istream& input, size_t chunkBytes = 1 << 20, char delimiter = ',')
+        : in(input), buffer(chunkBytes > 0 ? chunkBytes : 1 << 20), delimiter(delimiter) {
+    }
+
+    // Advances to the next record; false at the end of the input
+    bool next() {
+        size_t recordEnd = 0, after = 0;
+        long long lineBreaks = 0;
+        while (true) {
+            if (begin == end && inputDone) return false;
+            if (begin < end && findRecordEnd(recordEnd, after, lineBreaks)) break;
+            if (inputDone) return false;
+            refill();
+        }
+        split(begin, recordEnd);
+        consumed += after - begin;
+        line = nextLine;
+        nextLine += lineBreaks;
+        begin = after;
+        return true;
+    }
+
+    size_t fieldCount() const { return fields.size(); }
+    std::string_view field(size_t i) const { return i < fields.size() ? fields[i] : std::string_view(); }
+    const std::vector<std::string_view>& record() const { return fields; }
+
+    // True for a line with nothing on it
+    bool isBlank() const { return fields.size() == 1 && csv_parse::trim(fields[0]).empty(); }
+
+    long long lineNumber() const { return line; }
+    std::uint64_t bytesConsumed() const { return consumed; }
+};
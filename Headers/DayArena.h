@@ -0,0 +1,41 @@
+// DSA concept used = Monotonic (bump-pointer) arena, released in bulk
+
+#pragma once
+#include <memory_resource>
+#include <memory>
+#include <cstddef>
+
+/*
+    Scratch memory for one simulated day. Allocations are pointer bumps into
+    a block owned by the arena; freeing is a no-op. reset() drops everything
+    allocated since the last reset in one step and keeps the first block for
+    the next day, so a day that fits into it never touches the global heap.
+    When a day needs more, the arena grows from the default heap and gives
+    that memory back on reset.
+
+    Anything allocated from resource() must be gone before reset(): use it for
+    data that lives no longer than the day, such as the notes of the requests
+    processed that day. Single-threaded, like the day loop.
+*/
+class DayArena {
+    size_t initialBytes;
+    std::unique_ptr<std::byte[]> initialBlock;
+    std::pmr::monotonic_buffer_resource arena;
+
+public:
+    explicit DayArena(size_t initialBytes = 64 * 1024)
+        : initialBytes(initialBytes > 0 ? initialBytes : 1024),
+        initialBlock(new std::byte[this->initialBytes]),
+        arena(initialBlock.get(), this->initialBytes) {
+    }
+
+    DayArena(const DayArena&) = delete;
+    DayArena& operator=(const DayArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &arena; }
+
+    // Frees everything allocated today; call once the day's data is gone
+    void reset() { arena.release(); }
+
+    size_t blockSize() const { return initialBytes; }
+};
@@ -4,20 +4,36 @@
 #include "TransportationNetwork.h"
 #include <random>
 #include <iostream>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// What the disasters of one run did
+struct DisruptionStats {
+    int events = 0;                 // runRandomEvent calls
+    int routeDisruptions = 0;
+    int locationDisruptions = 0;
+    int shortageEvents = 0;
+    long long unitsLost = 0;        // stock destroyed by shortages
+};
 
 class DisasterSimulator {
     TransportationNetwork& network;  // Reference to the transportation network to simulate disruptions on
     std::mt19937 rng;                // Mersenne Twister random number generator for reproducible randomness
     EventLogger& logger;             // Reference to the event logger to record simulation events
+    std::ostream& out;               // Console messages ("[DISASTER] ...")
+    DisruptionStats counters;
 
 public:
-    // Constructor initializes references and seeds the random number generator with a non-deterministic seed
-    DisasterSimulator(TransportationNetwork& net, EventLogger& log)
-        : network(net), logger(log) {
-        std::random_device rd;      // Obtain seed from hardware entropy source if available
-        rng.seed(rd());             // Seed the RNG
+    // Constructor initializes references and seeds the random number generator.
+    // The same seed replays the same sequence of disasters on the same network.
+    DisasterSimulator(TransportationNetwork& net, EventLogger& log,
+        std::uint32_t seed = std::random_device{}(), std::ostream& out = std::cout)
+        : network(net), rng(seed), logger(log), out(out) {
     }
 
+    const DisruptionStats& stats() const { return counters; }
+
     // Simulates a disruption on one of the edges connected to the central warehouse (location ID = 1)
     void simulateNetworkDisruption() {
         // Collect all edges originating from the central warehouse location (ID = 1)
@@ -41,15 +57,60 @@ public:
         // Log the disruption event
         logger.logNetworkChange(selectedEdge.first, selectedEdge.second, false);
 
+        ++counters.routeDisruptions;
+
         // Inform console users of the disruption
-        std::cout << "\n[DISASTER] Route between locations " << selectedEdge.first
+        out << "\n[DISASTER] Route between locations " << selectedEdge.first
             << " and " << selectedEdge.second << " has been disrupted!\n";
     }
 
-    // Runs a random disaster event chosen from network disruption, resource shortage, or location disruption
+    /*
+        Takes every operational location within radiusKm of an epicentre offline
+        (e.g. an earthquake or flood zone), except the central warehouse (ID = 1).
+        Returns how many went offline.
+    */
+    int simulateRegionalDisruption(double latitude, double longitude, double radiusKm) {
+        std::vector<SpatialNeighbor> affected;
+        network.findLocationsWithinRadius(latitude, longitude, radiusKm, affected);
+
+        int disrupted = 0;
+        for (const SpatialNeighbor& hit : affected) {
+            Location* loc = network.getLocation(hit.id);
+            if (!loc || !loc->isOperational || hit.id == 1) continue;
+            network.updateLocationStatus(hit.id, false);
+            logger.logLocationStatus(hit.id, loc->name, false);
+            ++counters.locationDisruptions;
+            ++disrupted;
+        }
+
+        if (disrupted > 0) {
+            out << "\n[DISASTER] " << disrupted << " location(s) within " << radiusKm
+                << " km of (" << latitude << ", " << longitude << ") are now OFFLINE\n";
+        }
+        return disrupted;
+    }
+
+    // Regional disruption of 0.5 to 3 km around a randomly chosen location other than the warehouse
+    void simulateRandomRegionalDisruption() {
+        std::vector<int> locationIds;
+        for (const auto& entry : network.getLocations()) {
+            if (entry.first != 1) locationIds.push_back(entry.first);
+        }
+        if (locationIds.empty()) return;
+        // Sorted so the same seed picks the same epicentre whatever the map's iteration order
+        std::sort(locationIds.begin(), locationIds.end());
+
+        std::uniform_int_distribution<size_t> locDist(0, locationIds.size() - 1);
+        const Location* epicentre = network.getLocation(locationIds[locDist(rng)]);
+        double radiusKm = std::uniform_real_distribution<double>(0.5, 3.0)(rng);
+        simulateRegionalDisruption(epicentre->latitude, epicentre->longitude, radiusKm);
+    }
+
+    // Runs a random disaster event: network, resource shortage, location or regional disruption
     void runRandomEvent(ResourceManager& rm) {
-        std::uniform_int_distribution<int> eventTypeDist(0, 2);
+        std::uniform_int_distribution<int> eventTypeDist(0, 3);
         int eventType = eventTypeDist(rng);
+        ++counters.events;
 
         switch (eventType) {
         case 0:
@@ -61,6 +122,9 @@ public:
         case 2:
             simulateLocationDisruption();
             break;
+        case 3:
+            simulateRandomRegionalDisruption();
+            break;
         default:
             // Should never happen, but included for completeness
             break;
@@ -70,11 +134,14 @@ public:
     // Simulates a shortage for a randomly selected resource by reducing its available quantity
     void simulateResourceShortage(ResourceManager& rm) {
         // Define the set of possible resource types to affect
-        static const std::vector<std::string> resourceTypes = { "Medical Kits", "Water", "Emergency Food", "Blankets", "Medicines" };
+        static const std::vector<ResourceTypeId> resourceTypes = {
+            internResourceType("Medical Kits"), internResourceType("Water"), internResourceType("Emergency Food"),
+            internResourceType("Blankets"), internResourceType("Medicines")
+        };
 
         // Select a random resource type
         std::uniform_int_distribution<size_t> typeDist(0, resourceTypes.size() - 1);
-        std::string type = resourceTypes[typeDist(rng)];
+        ResourceTypeId type = resourceTypes[typeDist(rng)];
 
         // Get a pointer to the Resource object
         Resource* res = rm.getResource(type);
@@ -95,12 +162,13 @@ public:
             res->consume(reductionAmount); // Reduce the resource availability
 
             // Log the shortage event with detailed info
-            logger.log("Resource shortage: " + type + " reduced by "
-                + std::to_string(reductionAmount) + " units ("
-                + std::to_string(reductionPercent) + "%)");
+            logger.logResourceShortage(res->typeId, reductionAmount, reductionPercent);
+
+            ++counters.shortageEvents;
+            counters.unitsLost += reductionAmount;
 
             // Notify users on console
-            std::cout << "\n[DISASTER] " << type << " shortage! Lost "
+            out << "\n[DISASTER] " << res->type << " shortage! Lost "
                 << reductionAmount << " units (" << reductionPercent << "%)\n";
         }
     }
@@ -131,14 +199,16 @@ public:
             return;
         }
 
-        // Mark the location as non-operational
-        loc->updateStatus(false);
+        // Mark the location as non-operational (the network reroutes around it)
+        network.updateLocationStatus(selectedLocationId, false);
 
         // Log this disruption event with location name and ID
-        logger.log("Location " + std::to_string(selectedLocationId) + " (" + loc->name + ") is now OFFLINE");
+        logger.logLocationStatus(selectedLocationId, loc->name, false);
+
+        ++counters.locationDisruptions;
 
         // Notify via console output
-        std::cout << "\n[DISASTER] Location " << selectedLocationId
+        out << "\n[DISASTER] Location " << selectedLocationId
             << " (" << loc->name << ") is now OFFLINE\n";
     }
 };
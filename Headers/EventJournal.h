@@ -0,0 +1,348 @@
+// DSA concept used = Append-only binary log with varint (LEB128) encoding
+
+#pragma once
+#include "ResourceTypeRegistry.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+
+/*
+    Binary journal of simulation events, written next to (or instead of) the
+    text log.
+
+    File layout: an 8-byte header ("RRPJ", format version, 3 reserved bytes),
+    the wall-clock start time as 8 little-endian bytes, then one record per
+    event. Every record has the same shape for its kind:
+        kind (1 byte) | time delta (varint, ns since the previous record) | fields (varints)
+    Signed fields are zigzag encoded. Resource types are written as ids; the
+    first record using an id is preceded by a RESOURCE_TYPE record with its
+    name, so a journal can be read by a process that interned types differently.
+    Times come from steady_clock and never go backwards.
+*/
+enum class JournalRecordKind : std::uint8_t {
+    RESOURCE_TYPE = 1,      // a = type id, name
+    REQUEST = 2,            // a = request id, b = source, c = target, d = type, e = quantity, f = priority, g = status
+    ALLOCATION = 3,         // a = source, b = target, c = type, d = quantity, e = AllocationKind
+    EDGE_STATUS = 4,        // a = from, b = to, c = operational
+    LOCATION_STATUS = 5,    // a = location, b = operational
+    RESOURCE_CONSUMED = 6,  // a = type, b = quantity
+    EDGE_LOAD = 7,          // a = from, b = to, c = load change (negative when load came off)
+    SHIPMENT_ARRIVAL = 8    // a = source, b = target, c = type, d = quantity
+};
+
+// Where the units of an ALLOCATION record came from and when they reached the target
+enum class AllocationKind : std::uint8_t {
+    CENTRAL = 0,                // central stock, delivered at once
+    RELOCATION = 1,             // the source location's own stock, delivered at once
+    CENTRAL_SHIPMENT = 2,       // central stock, delivered by a later SHIPMENT_ARRIVAL record
+    RELOCATION_SHIPMENT = 3     // the source location's stock, delivered by a later SHIPMENT_ARRIVAL
+};
+
+// One decoded record; fields that a kind does not use are zero
+struct JournalRecord {
+    JournalRecordKind kind = JournalRecordKind::REQUEST;
+    std::int64_t timeNs = 0;        // since the journal was opened
+    std::int64_t a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0;
+    std::string name;               // RESOURCE_TYPE only
+};
+
+namespace journal_format {
+    constexpr char MAGIC[4] = { 'R', 'R', 'P', 'J' };
+    constexpr std::uint8_t VERSION = 2;
+    constexpr size_t HEADER_SIZE = 16;
+
+    // Number of varint fields stored for each kind (index = kind)
+    constexpr int FIELD_COUNT[9] = { 0, 1, 7, 5, 3, 2, 2, 3, 4 };
+    constexpr std::uint8_t LAST_KIND = 8;
+
+    inline std::uint64_t zigzag(std::int64_t v) {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+    inline std::int64_t unzigzag(std::uint64_t v) {
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    // False if the varint runs past `end` or is longer than 10 bytes
+    inline bool getVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            std::uint8_t byte = *p++;
+            v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+}
+
+/*
+    Appends records to a journal file. Records are encoded into an in-memory
+    buffer that is written out in large chunks; all methods are thread-safe.
+*/
+class EventJournalWriter {
+    std::ofstream file;
+    std::vector<std::uint8_t> buffer;
+    std::mutex mutex;
+    std::chrono::steady_clock::time_point start;
+    std::int64_t lastNs = 0;
+    std::uint64_t typesWritten = 0;     // bit per resource type id already described
+    std::uint64_t recordCount = 0;
+
+    static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    // Starts a record; the caller appends its fields. Must hold the mutex
+    void beginRecord(JournalRecordKind kind) {
+        std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (now < lastNs) now = lastNs;
+        buffer.push_back(static_cast<std::uint8_t>(kind));
+        journal_format::putVarint(buffer, static_cast<std::uint64_t>(now - lastNs));
+        lastNs = now;
+        ++recordCount;
+    }
+
+    void putInt(std::int64_t v) { journal_format::putVarint(buffer, journal_format::zigzag(v)); }
+
+    void finishRecord() {
+        if (buffer.size() >= FLUSH_THRESHOLD) writeBuffer();
+    }
+
+    // Makes sure the reader can map `type` back to a name. Must hold the mutex
+    void describeType(ResourceTypeId type) {
+        if (type >= MAX_RESOURCE_TYPES || (typesWritten >> type) & 1) return;
+        typesWritten |= std::uint64_t(1) << type;
+        const std::string& name = resourceTypeName(type);
+        beginRecord(JournalRecordKind::RESOURCE_TYPE);
+        putInt(type);
+        journal_format::putVarint(buffer, name.size());
+        buffer.insert(buffer.end(), name.begin(), name.end());
+    }
+
+    void writeBuffer() {
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+public:
+    EventJournalWriter() = default;
+    EventJournalWriter(const EventJournalWriter&) = delete;
+    EventJournalWriter& operator=(const EventJournalWriter&) = delete;
+
+    ~EventJournalWriter() { close(); }
+
+    // Creates (truncates) the journal file and writes its header
+    bool open(const std::string& filename) {
+        std::lock_guard<std::mutex> lock(mutex);
+        file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        start = std::chrono::steady_clock::now();
+        lastNs = 0;
+        typesWritten = 0;
+        recordCount = 0;
+        std::int64_t wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        std::uint8_t header[journal_format::HEADER_SIZE] = {};
+        std::memcpy(header, journal_format::MAGIC, 4);
+        header[4] = journal_format::VERSION;
+        for (int i = 0; i < 8; ++i) header[8 + i] = static_cast<std::uint8_t>(static_cast<std::uint64_t>(wallNs) >> (8 * i));
+        buffer.assign(header, header + journal_format::HEADER_SIZE);
+        return true;
+    }
+
+    bool isOpen() const { return file.is_open(); }
+    std::uint64_t records() const { return recordCount; }
+
+    // Writes out buffered records
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        writeBuffer();
+        file.flush();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        writeBuffer();
+        file.close();
+    }
+
+    void request(int requestId, int source, int target, ResourceTypeId type, int quantity, int priority, int status) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        describeType(type);
+        beginRecord(JournalRecordKind::REQUEST);
+        putInt(requestId); putInt(source); putInt(target); putInt(type);
+        putInt(quantity); putInt(priority); putInt(status);
+        finishRecord();
+    }
+
+    void allocation(int source, int target, ResourceTypeId type, int quantity, AllocationKind kind) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        describeType(type);
+        beginRecord(JournalRecordKind::ALLOCATION);
+        putInt(source); putInt(target); putInt(type); putInt(quantity); putInt(static_cast<int>(kind));
+        finishRecord();
+    }
+
+    void shipmentArrival(int source, int target, ResourceTypeId type, int quantity) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        describeType(type);
+        beginRecord(JournalRecordKind::SHIPMENT_ARRIVAL);
+        putInt(source); putInt(target); putInt(type); putInt(quantity);
+        finishRecord();
+    }
+
+    void edgeStatus(int from, int to, bool operational) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        beginRecord(JournalRecordKind::EDGE_STATUS);
+        putInt(from); putInt(to); putInt(operational ? 1 : 0);
+        finishRecord();
+    }
+
+    void locationStatus(int locationId, bool operational) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        beginRecord(JournalRecordKind::LOCATION_STATUS);
+        putInt(locationId); putInt(operational ? 1 : 0);
+        finishRecord();
+    }
+
+    void resourceConsumed(ResourceTypeId type, int quantity) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        describeType(type);
+        beginRecord(JournalRecordKind::RESOURCE_CONSUMED);
+        putInt(type); putInt(quantity);
+        finishRecord();
+    }
+
+    void edgeLoad(int from, int to, int load) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file.is_open()) return;
+        beginRecord(JournalRecordKind::EDGE_LOAD);
+        putInt(from); putInt(to); putInt(load);
+        finishRecord();
+    }
+};
+
+/*
+    Reads a journal back record by record. The whole file is loaded at once
+    and decoded in place. Resource type ids in the returned records are
+    already translated to this process's registry.
+*/
+class EventJournalReader {
+    std::vector<std::uint8_t> data;
+    const std::uint8_t* cursor = nullptr;
+    const std::uint8_t* end = nullptr;
+    std::int64_t clockNs = 0;
+    std::int64_t startWallNs = 0;
+    std::vector<ResourceTypeId> typeMap;    // file id -> local id
+    bool corrupt = false;
+
+    ResourceTypeId localType(std::int64_t fileId) const {
+        return fileId >= 0 && fileId < static_cast<std::int64_t>(typeMap.size())
+            ? typeMap[fileId] : INVALID_RESOURCE_TYPE;
+    }
+
+public:
+    // Loads the file and checks its header; false if it is missing or not a journal
+    bool open(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) return false;
+        std::streamoff size = in.tellg();
+        if (size < static_cast<std::streamoff>(journal_format::HEADER_SIZE)) return false;
+        data.resize(static_cast<size_t>(size));
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(data.data()), size)) return false;
+        if (std::memcmp(data.data(), journal_format::MAGIC, 4) != 0 || data[4] != journal_format::VERSION) return false;
+
+        std::uint64_t wall = 0;
+        for (int i = 0; i < 8; ++i) wall |= static_cast<std::uint64_t>(data[8 + i]) << (8 * i);
+        startWallNs = static_cast<std::int64_t>(wall);
+        cursor = data.data() + journal_format::HEADER_SIZE;
+        end = data.data() + data.size();
+        clockNs = 0;
+        typeMap.assign(MAX_RESOURCE_TYPES, INVALID_RESOURCE_TYPE);
+        corrupt = false;
+        return true;
+    }
+
+    // Wall-clock time the journal was started, in ns since the epoch
+    std::int64_t startTimeNs() const { return startWallNs; }
+
+    // True if reading stopped at a damaged or truncated record
+    bool isCorrupt() const { return corrupt; }
+
+    /*
+        Decodes the next record into `out`. Returns false at the end of the
+        journal or at a damaged record (see isCorrupt). RESOURCE_TYPE records
+        are consumed here and also returned so callers can see them.
+    */
+    bool next(JournalRecord& out) {
+        if (cursor == nullptr || cursor >= end) return false;
+        const std::uint8_t* p = cursor;
+        std::uint8_t kind = *p++;
+        std::uint64_t delta = 0;
+        if (kind < 1 || kind > journal_format::LAST_KIND || !journal_format::getVarint(p, end, delta)) {
+            corrupt = true;
+            return false;
+        }
+
+        std::int64_t fields[7] = {};
+        int count = journal_format::FIELD_COUNT[kind];
+        for (int i = 0; i < count; ++i) {
+            std::uint64_t raw = 0;
+            if (!journal_format::getVarint(p, end, raw)) {
+                corrupt = true;
+                return false;
+            }
+            fields[i] = journal_format::unzigzag(raw);
+        }
+
+        out.kind = static_cast<JournalRecordKind>(kind);
+        out.name.clear();
+        if (out.kind == JournalRecordKind::RESOURCE_TYPE) {
+            std::uint64_t length = 0;
+            if (!journal_format::getVarint(p, end, length) || length > static_cast<std::uint64_t>(end - p)) {
+                corrupt = true;
+                return false;
+            }
+            out.name.assign(reinterpret_cast<const char*>(p), static_cast<size_t>(length));
+            p += length;
+            if (fields[0] >= 0 && fields[0] < MAX_RESOURCE_TYPES) typeMap[fields[0]] = internResourceType(out.name);
+        }
+
+        // Translate resource type fields to local ids
+        switch (out.kind) {
+        case JournalRecordKind::REQUEST: fields[3] = localType(fields[3]); break;
+        case JournalRecordKind::ALLOCATION: fields[2] = localType(fields[2]); break;
+        case JournalRecordKind::SHIPMENT_ARRIVAL: fields[2] = localType(fields[2]); break;
+        case JournalRecordKind::RESOURCE_CONSUMED: fields[0] = localType(fields[0]); break;
+        default: break;
+        }
+
+        clockNs += static_cast<std::int64_t>(delta);
+        out.timeNs = clockNs;
+        out.a = fields[0]; out.b = fields[1]; out.c = fields[2]; out.d = fields[3];
+        out.e = fields[4]; out.f = fields[5]; out.g = fields[6];
+        cursor = p;
+        return true;
+    }
+};
@@ -1,16 +1,155 @@
 #pragma once
 #include "Utilities.h"  // For utility functions like getCurrentTimestamp()
 #include "Request.h"    // Definition of Request class and related enums
+#include "LogRingBuffer.h"
+#include "EventJournal.h"
+#include "Metrics.h"
 #include <fstream>      // File stream for logging output
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
 
+enum class LogOverflowPolicy { BLOCK, DROP };
+
+struct AsyncLogOptions {
+    size_t capacity = 8192;             // ring size in records (rounded up to a power of two)
+    size_t batchSize = 256;             // records written per batch
+    int flushIntervalMs = 200;          // flush at most this long after a record was written
+    bool flushEveryBatch = false;       // flush after every batch instead
+    LogOverflowPolicy overflow = LogOverflowPolicy::BLOCK;
+};
+
+/*
+    Writes timestamped events to a log file (and optionally the console).
+
+    Typed events (requests, allocations, route/location changes, shortages) can
+    also go to a binary EventJournal (openJournal); with setTextLog(false) they
+    are journaled only and no text is formatted at all.
+
+    By default every log() call writes and flushes synchronously. After
+    startAsync() callers only move a preformatted record into a lock-free ring;
+    a background thread formats the timestamps, writes records in batches and
+    flushes according to the flush policy. When the ring is full the overflow
+    policy decides whether the caller waits for space or the record is dropped;
+    both cases are counted in stats().
+*/
 class EventLogger {
+public:
+    using OverflowPolicy = LogOverflowPolicy;
+    using AsyncOptions = AsyncLogOptions;
+
+    struct Stats {
+        std::uint64_t logged;       // records accepted
+        std::uint64_t written;      // records written to the file
+        std::uint64_t dropped;      // records lost because the ring was full (DROP)
+        std::uint64_t blocked;      // log() calls that had to wait for space (BLOCK)
+        std::uint64_t flushes;
+        size_t queued;              // records waiting in the ring (approximate)
+    };
+
+private:
     std::ofstream logFile; // Output file stream for writing log entries to a file
     bool enabled;          // Flag to indicate if logging is enabled (file opened successfully)
+    std::atomic<bool> consoleEcho{ true };   // also print each message to std::cout
+    bool textLog = true;                     // false = typed events go to the journal only
+    EventJournalWriter journal;
+
+    // Async mode
+    AsyncOptions options;
+    std::unique_ptr<LogRingBuffer> ring;     // null in synchronous mode
+    std::thread writer;
+    std::atomic<bool> stopping{ false };
+    std::mutex wakeMutex;
+    std::condition_variable wakeUp;
+
+    std::atomic<std::uint64_t> loggedCount{ 0 };
+    std::atomic<std::uint64_t> writtenCount{ 0 };
+    std::atomic<std::uint64_t> droppedCount{ 0 };
+    std::atomic<std::uint64_t> blockedCount{ 0 };
+    std::atomic<std::uint64_t> flushCount{ 0 };
+
+    void enqueue(std::string message) {
+        LogRecord record{ nowTimestamp(), std::move(message) };
+        if (!ring->tryPush(record)) {
+            if (options.overflow == OverflowPolicy::DROP) {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            blockedCount.fetch_add(1, std::memory_order_relaxed);
+            do {
+                wakeUp.notify_one();
+                std::this_thread::yield();
+            } while (!ring->tryPush(record));
+        }
+        loggedCount.fetch_add(1, std::memory_order_relaxed);
+        // Wake the writer early once a full batch is waiting; otherwise it wakes on its timer
+        if (ring->depth() >= options.batchSize) wakeUp.notify_one();
+    }
+
+    // Background thread: drains the ring in batches until stopAsync()
+    void writerLoop() {
+        using Clock = std::chrono::steady_clock;
+        std::string buffer;
+        std::string echo;
+        LogRecord record;
+        bool dirty = false;                   // written but not flushed yet
+        Clock::time_point firstUnflushed;
+        const auto interval = std::chrono::milliseconds(std::max(1, options.flushIntervalMs));
+
+        while (true) {
+            bool stop = stopping.load(std::memory_order_acquire);
+            size_t count = 0;
+            buffer.clear();
+            echo.clear();
+            bool echoing = consoleEcho.load(std::memory_order_relaxed);
+            while (count < options.batchSize && ring->tryPop(record)) {
+                buffer += '[';
+                appendTimestamp(buffer, record.wallClockNs);
+                buffer += "] ";
+                buffer += record.text;
+                buffer += '\n';
+                if (echoing) {
+                    echo += "[LOG] ";
+                    echo += record.text;
+                    echo += '\n';
+                }
+                ++count;
+            }
+            ring->publishConsumed();
+
+            if (count > 0) {
+                logFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                if (echoing) std::cout << echo;
+                writtenCount.fetch_add(count, std::memory_order_relaxed);
+                if (!dirty) firstUnflushed = Clock::now();
+                dirty = true;
+            }
+            if (dirty && (options.flushEveryBatch || stop || Clock::now() - firstUnflushed >= interval)) {
+                logFile.flush();
+                if (echoing) std::cout.flush();
+                flushCount.fetch_add(1, std::memory_order_relaxed);
+                dirty = false;
+            }
+
+            if (count == options.batchSize) continue;   // more may be waiting
+            if (stop) return;                           // ring drained after the stop request
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeUp.wait_for(lock, dirty ? interval : interval * 5);
+        }
+    }
 
 public:
     // Constructor opens the log file in append mode.
     // If the file can't be opened, disables logging and prints a warning.
+    // An empty filename turns logging off without a warning.
     EventLogger(const std::string& filename = "resource_allocation.log") : enabled(true) {
+        if (filename.empty()) {
+            enabled = false;
+            return;
+        }
         logFile.open(filename, std::ios::app); // Open file in append mode to keep existing logs
         if (!logFile.is_open()) {
             std::cerr << "Warning: Could not open log file: " << filename << "\n";
@@ -18,33 +157,105 @@ public:
         }
     }
 
-    // Destructor closes the log file if it is open
+    // Destructor writes out anything still queued and closes the log file
     ~EventLogger() {
+        stopAsync();
+        journal.close();
         if (logFile.is_open()) {
             logFile.close();
         }
     }
 
+    EventLogger(const EventLogger&) = delete;
+    EventLogger& operator=(const EventLogger&) = delete;
+
+    /*
+        Switches to asynchronous logging with a background writer thread.
+        Returns false if logging is disabled or async mode is already running.
+    */
+    bool startAsync(const AsyncOptions& asyncOptions = AsyncOptions()) {
+        if (!enabled || ring) return false;
+        options = asyncOptions;
+        if (options.batchSize == 0) options.batchSize = 1;
+        ring.reset(new LogRingBuffer(std::max<size_t>(options.capacity, 2)));
+        stopping.store(false, std::memory_order_relaxed);
+        writer = std::thread([this] { writerLoop(); });
+        return true;
+    }
+
+    /*
+        Writes out every queued record, stops the writer thread and goes back to
+        synchronous logging. Must not race with log() calls from other threads.
+    */
+    void stopAsync() {
+        if (!ring) return;
+        stopping.store(true, std::memory_order_release);
+        wakeUp.notify_one();
+        writer.join();
+        ring.reset();
+    }
+
+    bool isAsync() const { return ring != nullptr; }
+
+    // Starts a binary journal of typed events (see EventJournal.h); false if the file can't be created
+    bool openJournal(const std::string& filename) { return journal.open(filename); }
+    void closeJournal() { journal.close(); }
+    EventJournalWriter& eventJournal() { return journal; }
+
+    // Text log of typed events on/off (plain log() messages are always written)
+    void setTextLog(bool on) { textLog = on; }
+
+    // Console echo of log messages ("[LOG] ..."); on by default
+    void setConsoleEcho(bool echo) { consoleEcho.store(echo, std::memory_order_relaxed); }
+
+    Stats stats() const {
+        Stats s;
+        s.logged = loggedCount.load(std::memory_order_relaxed);
+        s.written = writtenCount.load(std::memory_order_relaxed);
+        s.dropped = droppedCount.load(std::memory_order_relaxed);
+        s.blocked = blockedCount.load(std::memory_order_relaxed);
+        s.flushes = flushCount.load(std::memory_order_relaxed);
+        s.queued = ring ? ring->depth() : 0;
+        return s;
+    }
+
     // General logging function that writes a timestamped message to the log file
-    // and also prints it to the console.
+    // and also prints it to the console (if console echo is on).
+    // Thread-safe in async mode; the synchronous mode is single-threaded.
     void log(const std::string& message) {
         if (!enabled) return; // Skip logging if disabled
+        RRP_METRIC_TIMER(timer, LOG_LATENCY);
+        RRP_METRIC_ADD(LOG_RECORDS, 1);
+        RRP_METRIC_ADD(LOG_BYTES, message.size());
+
+        if (ring) {
+            enqueue(message);
+            return;
+        }
 
         std::string timestamp = getCurrentTimestamp(); // Get current timestamp as string
         logFile << "[" << timestamp << "] " << message << std::endl; // Write timestamped message to file
+        loggedCount.fetch_add(1, std::memory_order_relaxed);
+        writtenCount.fetch_add(1, std::memory_order_relaxed);
 
         // Also output the log message to the standard output for real-time monitoring
-        std::cout << "[LOG] " << message << std::endl;
+        if (consoleEcho.load(std::memory_order_relaxed)) {
+            std::cout << "[LOG] " << message << std::endl;
+        }
     }
 
     // Logs detailed information about a Request object,
     // including its ID, resource type, quantity, source and target locations, and status.
     void logRequest(const Request& req) {
-        if (!enabled) return;
+        if (journal.isOpen()) {
+            journal.request(req.requestId, req.sourceLocationId, req.targetLocationId, req.resourceTypeId,
+                req.requiredQuantity, req.priority, static_cast<int>(req.status));
+        }
+        if (!enabled || !textLog) return;
 
         // Compose a descriptive log message for the request event
         std::string message = "Request #" + std::to_string(req.requestId) +
-            " (" + req.resourceType + " x" + std::to_string(req.requiredQuantity) +
+            " (" + req.resourceType() + " x" + std::to_string(req.requiredQuantity) +
             ") from Loc" + std::to_string(req.sourceLocationId) +
             " to Loc" + std::to_string(req.targetLocationId) +
             " - Status: " + Request::statusToString(req.status);
@@ -54,23 +265,37 @@ public:
 
     // Logs an allocation event specifying source and target locations,
     // resource type and quantity, and the time of allocation.
-    void logAllocation(int sourceId, int targetId, const std::string& resourceType,
-        int quantity, const std::string& timestamp) {
-        if (!enabled) return;
+    // `kind` tells a journal replay which stock the units came from and whether they are still travelling.
+    void logAllocation(int sourceId, int targetId, ResourceTypeId resourceType,
+        int quantity, Timestamp timestamp, AllocationKind kind = AllocationKind::CENTRAL) {
+        if (journal.isOpen()) journal.allocation(sourceId, targetId, resourceType, quantity, kind);
+        if (!enabled || !textLog) return;
 
         // Compose the allocation log message with all relevant details
-        std::string message = "Allocated " + resourceType + " x" + std::to_string(quantity) +
+        std::string message = "Allocated " + resourceTypeName(resourceType) + " x" + std::to_string(quantity) +
             " from Loc" + std::to_string(sourceId) +
             " to Loc" + std::to_string(targetId) +
-            " at " + timestamp;
+            " at " + formatTimestamp(timestamp);
+        if (kind == AllocationKind::RELOCATION || kind == AllocationKind::RELOCATION_SHIPMENT) message += " (local stock)";
+        if (kind == AllocationKind::CENTRAL_SHIPMENT || kind == AllocationKind::RELOCATION_SHIPMENT) message += " (in transit)";
 
         log(message);
     }
 
+    // Logs a shipment reaching its target (see ShipmentScheduler)
+    void logShipmentArrival(int sourceId, int targetId, ResourceTypeId resourceType, int quantity) {
+        if (journal.isOpen()) journal.shipmentArrival(sourceId, targetId, resourceType, quantity);
+        if (!enabled || !textLog) return;
+
+        log("Shipment of " + resourceTypeName(resourceType) + " x" + std::to_string(quantity) +
+            " from Loc" + std::to_string(sourceId) + " arrived at Loc" + std::to_string(targetId));
+    }
+
     // Logs changes in network routes between two locations,
     // indicating if the route is operational or closed.
     void logNetworkChange(int from, int to, bool isOperational) {
-        if (!enabled) return;
+        if (journal.isOpen()) journal.edgeStatus(from, to, isOperational);
+        if (!enabled || !textLog) return;
 
         // Compose a message reflecting the route status change
         std::string message = "Route from Loc" + std::to_string(from) +
@@ -79,4 +304,23 @@ public:
 
         log(message);
     }
+
+    // Logs a location going offline or coming back
+    void logLocationStatus(int locationId, const std::string& name, bool isOperational) {
+        if (journal.isOpen()) journal.locationStatus(locationId, isOperational);
+        if (!enabled || !textLog) return;
+
+        log("Location " + std::to_string(locationId) + " (" + name + ") is now " +
+            (isOperational ? "ONLINE" : "OFFLINE"));
+    }
+
+    // Logs stock lost to a shortage event
+    void logResourceShortage(ResourceTypeId resourceType, int quantity, int percent) {
+        if (journal.isOpen()) journal.resourceConsumed(resourceType, quantity);
+        if (!enabled || !textLog) return;
+
+        log("Resource shortage: " + resourceTypeName(resourceType) + " reduced by "
+            + std::to_string(quantity) + " units ("
+            + std::to_string(percent) + "%)");
+    }
 };
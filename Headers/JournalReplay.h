@@ -0,0 +1,99 @@
+// DSA concept used = Event sourcing: sequential replay of an append-only log
+
+#pragma once
+#include "EventJournal.h"
+#include "TransportationNetwork.h"
+#include "ResourceManager.h"
+#include <cstdint>
+
+// What a replay applied
+struct JournalReplayStats {
+    std::uint64_t records = 0;
+    std::uint64_t requests = 0;         // seen only; requests are not network or inventory state
+    std::uint64_t allocations = 0;
+    std::uint64_t deliveries = 0;       // shipment arrivals
+    std::uint64_t edgeChanges = 0;
+    std::uint64_t locationChanges = 0;
+    std::uint64_t shortages = 0;
+    std::uint64_t edgeLoads = 0;
+    std::uint64_t failed = 0;           // records whose change could not be applied
+    bool complete = false;              // false if the journal ended in a damaged record
+};
+
+/*
+    Re-applies the state changes recorded in a journal to `network` and `rm`.
+    Both must start from the same setup the journal was recorded on (the same
+    locations, routes and resources); the replay then brings them to the state
+    at the end of the recorded run without re-running routing or scheduling.
+*/
+inline JournalReplayStats replayJournal(EventJournalReader& reader, TransportationNetwork& network, ResourceManager& rm) {
+    JournalReplayStats stats;
+    JournalRecord r;
+    while (reader.next(r)) {
+        ++stats.records;
+        switch (r.kind) {
+        case JournalRecordKind::RESOURCE_TYPE:
+            break;
+        case JournalRecordKind::REQUEST:
+            ++stats.requests;
+            break;
+        case JournalRecordKind::ALLOCATION: {
+            // Each kind takes its units from where the recorded run took them
+            ResourceTypeId type = static_cast<ResourceTypeId>(r.c);
+            int source = static_cast<int>(r.a);
+            int target = static_cast<int>(r.b);
+            int quantity = static_cast<int>(r.d);
+            bool applied = false;
+            switch (static_cast<AllocationKind>(r.e)) {
+            case AllocationKind::CENTRAL: applied = rm.allocateResources(type, quantity, source, target); break;
+            case AllocationKind::RELOCATION: applied = rm.relocateStock(source, target, type, quantity); break;
+            case AllocationKind::CENTRAL_SHIPMENT:
+                applied = rm.withdrawForShipment(source, target, type, quantity, false);
+                break;
+            case AllocationKind::RELOCATION_SHIPMENT:
+                applied = rm.withdrawForShipment(source, target, type, quantity, true);
+                break;
+            }
+            if (applied) ++stats.allocations;
+            else ++stats.failed;
+            break;
+        }
+        case JournalRecordKind::SHIPMENT_ARRIVAL:
+            if (Location* target = network.getLocation(static_cast<int>(r.b))) {
+                target->addResource(static_cast<ResourceTypeId>(r.c), static_cast<int>(r.d));
+                ++stats.deliveries;
+            }
+            else ++stats.failed;
+            break;
+        case JournalRecordKind::EDGE_STATUS:
+            network.updateEdgeStatus(static_cast<int>(r.a), static_cast<int>(r.b), r.c != 0);
+            ++stats.edgeChanges;
+            break;
+        case JournalRecordKind::LOCATION_STATUS:
+            network.updateLocationStatus(static_cast<int>(r.a), r.b != 0);
+            ++stats.locationChanges;
+            break;
+        case JournalRecordKind::RESOURCE_CONSUMED:
+            if (Resource* res = rm.getResource(static_cast<ResourceTypeId>(r.a))) {
+                res->consume(static_cast<int>(r.b));
+                ++stats.shortages;
+            }
+            else ++stats.failed;
+            break;
+        case JournalRecordKind::EDGE_LOAD:
+            if (r.c >= 0) network.addLoadToEdge(static_cast<int>(r.a), static_cast<int>(r.b), static_cast<int>(r.c));
+            else network.removeLoadFromEdge(static_cast<int>(r.a), static_cast<int>(r.b), static_cast<int>(-r.c));
+            ++stats.edgeLoads;
+            break;
+        }
+    }
+    stats.complete = !reader.isCorrupt();
+    return stats;
+}
+
+// Opens `filename` and replays it; `complete` is false if it could not be read at all
+inline JournalReplayStats replayJournal(const std::string& filename, TransportationNetwork& network, ResourceManager& rm) {
+    EventJournalReader reader;
+    if (!reader.open(filename)) return JournalReplayStats();
+    return replayJournal(reader, network, rm);
+}
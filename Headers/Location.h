@@ -1,18 +1,45 @@
-// DSA concept used = Unordered Maps 
+// DSA concept used = Direct-address table (flat array indexed by resource type id)
 
 #pragma once
+#include "ResourceTypeRegistry.h"
+#include "CriticalLevelWatcher.h"
 #include <string>
-#include <unordered_map>
+#include <array>
+#include <cstdint>
+#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 // Each location represents a physical place
 // Unique Id and name, placed on map using longitude and latitude 
 // can store people/supplies upto max capacity 
-// tracks the map of resources like food/water 
+// tracks the stock of resources like food/water, one slot per interned resource type
+// each slot is an atomic counter, so workers on several threads can take stock from
+// and deliver stock to the same location without locks (CAS-based reserve/release)
+// a type can have a critical level here too; crossings are reported to the watcher
 
 class Location {
+    friend class CriticalLevelTracker;
+
+    CriticalLevelWatcher* watcher = nullptr;   // set by CriticalLevelTracker::watch
+    std::array<int, MAX_RESOURCE_TYPES> alertSlots;   // position in the tracker's alert list, -1 if not listed
+
+    // Reports a change of one slot from `before` to `after` units if it crossed the critical level
+    void stockChanged(ResourceTypeId type, int before, int after) {
+        int level = criticalLevels[type];
+        if (watcher && level > 0 && (before < level) != (after < level)) watcher->locationStockChanged(*this, type);
+    }
+
+    void copyInventory(const Location& other) {
+        for (int type = 0; type < MAX_RESOURCE_TYPES; ++type) {
+            resourceInventory[type].store(other.resourceInventory[type].load(std::memory_order_acquire),
+                std::memory_order_relaxed);
+        }
+        stockedTypes.store(other.stockedTypes.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
 public:
     int id;
     std::string name;
@@ -20,14 +47,44 @@ public:
     bool isOperational;
     int maxCapacity;
     int currentOccupancy;
-    // hash table is created for mapping resoruces to quantity 
-    std::unordered_map<std::string, int> resourceInventory;
+    // quantity per resource type id; no hashing on lookup
+    std::array<std::atomic<int>, MAX_RESOURCE_TYPES> resourceInventory{};
+    // bit i set once type i was ever stocked here (so printInventory lists it, even at 0)
+    std::atomic<std::uint64_t> stockedTypes{ 0 };
+    // per type: alert when the stock drops below this (0 = no threshold); set through CriticalLevelTracker::watch
+    std::array<int, MAX_RESOURCE_TYPES> criticalLevels{};
 
     //constructor
     Location(int id, const std::string& name, double lat, double lon,
         bool operational = true, int capacity = 1000)
         : id(id), name(name), latitude(lat), longitude(lon),
         isOperational(operational), maxCapacity(capacity), currentOccupancy(0) {
+        alertSlots.fill(-1);
+    }
+
+    // Copies take a snapshot of the inventory counters and thresholds; the copy is not watched
+    Location(const Location& other)
+        : id(other.id), name(other.name), latitude(other.latitude), longitude(other.longitude),
+        isOperational(other.isOperational), maxCapacity(other.maxCapacity),
+        currentOccupancy(other.currentOccupancy), criticalLevels(other.criticalLevels) {
+        alertSlots.fill(-1);
+        copyInventory(other);
+    }
+
+    Location& operator=(const Location& other) {
+        id = other.id;
+        name = other.name;
+        latitude = other.latitude;
+        longitude = other.longitude;
+        isOperational = other.isOperational;
+        maxCapacity = other.maxCapacity;
+        currentOccupancy = other.currentOccupancy;
+        copyInventory(other);
+        criticalLevels = other.criticalLevels;
+        if (watcher) {
+            for (int type = 0; type < MAX_RESOURCE_TYPES; ++type) watcher->locationStockChanged(*this, static_cast<ResourceTypeId>(type));
+        }
+        return *this;
     }
 
     //in case of disaster for simulation it updates that whether location is active and can get resources
@@ -51,27 +108,54 @@ public:
         currentOccupancy = std::max(0, currentOccupancy - quantity);
     }
 
-    void addResource(const std::string& type, int quantity) {
-        if (quantity <= 0) return ;
-        resourceInventory[type] += quantity;
+    // thread-safe: one atomic add (plus marking the type as stocked the first time)
+    void addResource(ResourceTypeId type, int quantity) {
+        if (quantity <= 0 || type >= MAX_RESOURCE_TYPES) return ;
+        int before = resourceInventory[type].fetch_add(quantity, std::memory_order_acq_rel);
+        stockChanged(type, before, before + quantity);
+        std::uint64_t bit = std::uint64_t(1) << type;
+        if (!(stockedTypes.load(std::memory_order_relaxed) & bit)) stockedTypes.fetch_or(bit, std::memory_order_relaxed);
     }
 
-    // only allows the usage if enough quntity is available 
-    bool useResource(const std::string& type, int quantity) {
-        if (quantity <= 0) return false ;
-        // check if that type of resouce exists ans has enough data 
-        if (resourceInventory.count(type) && resourceInventory[type] >= quantity) {
-            resourceInventory[type] -= quantity;
-            return true;
+    // only allows the usage if enough quntity is available
+    // thread-safe: the check and the decrement are one compare-and-swap, so two
+    // workers can never both take the last units
+    bool useResource(ResourceTypeId type, int quantity) {
+        if (quantity <= 0 || type >= MAX_RESOURCE_TYPES) return false ;
+        std::atomic<int>& slot = resourceInventory[type];
+        int current = slot.load(std::memory_order_relaxed);
+        // check if that type of resouce has enough stock
+        while (current >= quantity) {
+            if (slot.compare_exchange_weak(current, current - quantity,
+                std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                stockChanged(type, current, current - quantity);
+                return true;
+            }
         }
         return false;
     }
 
+    // Reserve/release pair for two-phase allocations: a reservation takes the units
+    // out of the available stock right away, a release puts them back
+    bool reserveResource(ResourceTypeId type, int quantity) { return useResource(type, quantity); }
+    void releaseResource(ResourceTypeId type, int quantity) { addResource(type, quantity); }
+
     // tells how much resources are remaining 
-    // .find() will look up th resource in hash map
+    int getAvailableQuantity(ResourceTypeId type) const {
+        return type < MAX_RESOURCE_TYPES ? resourceInventory[type].load(std::memory_order_acquire) : 0;
+    }
+
+    // Name-based convenience overloads for the API boundary
+    void addResource(const std::string& type, int quantity) {
+        addResource(internResourceType(type), quantity);
+    }
+
+    bool useResource(const std::string& type, int quantity) {
+        return useResource(ResourceTypeRegistry::instance().find(type), quantity);
+    }
+
     int getAvailableQuantity(const std::string& type) const {
-        auto it = resourceInventory.find(type);
-        return (it != resourceInventory.end()) ? it->second : 0;
+        return getAvailableQuantity(ResourceTypeRegistry::instance().find(type));
     }
 
     void printInventory() const {
@@ -80,9 +164,26 @@ public:
         std::cout << "+-----------------------+---------------------+\n";
         std::cout << "| " << std::setw(21) << "Resource Type" << " | " << std::setw(19) << "Quantity" << " |\n";
         std::cout << "+-----------------------+---------------------+\n";
-        for (const auto& res : resourceInventory) {
-            std::cout << "| " << std::setw(21) << res.first << " | " << std::setw(19) << res.second << " |\n";
+        for (int type = 0; type < MAX_RESOURCE_TYPES; ++type) {
+            if (!(stockedTypes.load(std::memory_order_relaxed) >> type & 1)) continue;
+            std::cout << "| " << std::setw(21) << resourceTypeName(static_cast<ResourceTypeId>(type))
+                << " | " << std::setw(19) << getAvailableQuantity(static_cast<ResourceTypeId>(type)) << " |\n";
         }
         std::cout << "+-----------------------+---------------------+\n";
     }
 };
+
+// Great-circle (haversine) distance in kilometres between two latitude/longitude points
+inline double greatCircleDistanceKm(double lat1, double lon1, double lat2, double lon2) {
+    const double earthRadiusKm = 6371.0;
+    const double toRadians = 3.14159265358979323846 / 180.0;
+    double dLat = (lat2 - lat1) * toRadians;
+    double dLon = (lon2 - lon1) * toRadians;
+    double a = std::sin(dLat / 2) * std::sin(dLat / 2) +
+        std::cos(lat1 * toRadians) * std::cos(lat2 * toRadians) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2.0 * earthRadiusKm * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+inline double greatCircleDistanceKm(const Location& a, const Location& b) {
+    return greatCircleDistanceKm(a.latitude, a.longitude, b.latitude, b.longitude);
+}
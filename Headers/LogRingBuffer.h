@@ -0,0 +1,93 @@
+// DSA concept used = Bounded lock-free ring buffer (sequence-numbered slots)
+
+#pragma once
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// One preformatted log line waiting for the writer thread
+struct LogRecord {
+    std::int64_t wallClockNs = 0;   // Timestamp (ns since the epoch) the event was logged
+    std::string text;
+};
+
+/*
+    Fixed-capacity multi-producer / single-consumer ring used by the async
+    EventLogger. Each slot carries a sequence number that tells producers and the
+    consumer whose turn it is (Vyukov's bounded queue), so a push is one CAS on
+    the tail counter plus one release store, and a full ring is detected without
+    locks. The capacity is rounded up to a power of two.
+*/
+class LogRingBuffer {
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        LogRecord record;
+    };
+
+    std::vector<Slot> slots;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> enqueuePos{ 0 };
+    alignas(64) std::size_t dequeuePos = 0;   // consumer only
+    std::atomic<std::size_t> dequeuePosApprox{ 0 };   // dequeuePos as last published for depth()
+
+public:
+    explicit LogRingBuffer(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots = std::vector<Slot>(size);
+        for (std::size_t i = 0; i < size; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+        mask = size - 1;
+    }
+
+    LogRingBuffer(const LogRingBuffer&) = delete;
+    LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+    std::size_t capacity() const { return slots.size(); }
+
+    // Any thread. False if the ring is full; `record` is left untouched then
+    bool tryPush(LogRecord& record) {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[pos & mask];
+            std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;   // the consumer has not freed this slot yet
+            }
+            else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only. False if nothing is ready
+    bool tryPop(LogRecord& out) {
+        Slot& slot = slots[dequeuePos & mask];
+        std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != dequeuePos + 1) return false;
+        out = std::move(slot.record);
+        slot.record.text.clear();
+        slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    // Approximate number of queued records (any thread)
+    std::size_t depth() const {
+        std::size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        std::size_t head = dequeuePosApprox.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    // Published by the consumer after each batch so depth() works from producers
+    void publishConsumed() { dequeuePosApprox.store(dequeuePos, std::memory_order_relaxed); }
+};
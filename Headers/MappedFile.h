@@ -0,0 +1,115 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+    Read-only memory mapping of a whole file. The pages are loaded by the OS on
+    first touch, so opening is O(1) whatever the file size, and several
+    processes mapping the same file share one copy in the page cache.
+    Uses mmap on POSIX systems and a file mapping object on Windows.
+*/
+class MappedFile {
+    const std::uint8_t* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename) { open(filename); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this == &other) return *this;
+        close();
+        base = other.base;
+        length = other.length;
+        other.base = nullptr;
+        other.length = 0;
+#ifdef _WIN32
+        file = other.file;
+        mapping = other.mapping;
+        other.file = INVALID_HANDLE_VALUE;
+        other.mapping = nullptr;
+#endif
+        return *this;
+    }
+
+    // Maps the file; false if it cannot be opened or is empty
+    bool open(const std::string& filename) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            close();
+            return false;
+        }
+        base = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!base) {
+            close();
+            return false;
+        }
+        length = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);   // the mapping keeps the file alive
+        if (mapped == MAP_FAILED) return false;
+        base = static_cast<const std::uint8_t*>(mapped);
+        length = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap(const_cast<std::uint8_t*>(base), length);
+#endif
+        base = nullptr;
+        length = 0;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+    const std::uint8_t* data() const { return base; }
+    size_t size() const { return length; }
+};
@@ -0,0 +1,402 @@
+// DSA concept used = Per-thread counters and log-linear (HDR-style) histograms, merged on read
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/*
+    Hot-path instrumentation. Compile with -DRRP_METRICS to turn it on; without
+    it every RRP_METRIC_* macro compiles to nothing (its arguments are not even
+    evaluated), so the instrumented code runs exactly as before. The registry
+    and the exporters are always available and report zeros when disabled.
+
+    Each thread writes only its own block of counters and histograms (plain
+    relaxed loads and stores, no read-modify-write, no sharing), and a snapshot
+    adds up all blocks. Threads that exit fold their totals into the registry.
+    Metrics are process-wide: concurrent simulations add into the same totals.
+
+        RRP_METRIC_ADD(PATH_QUERIES, 1);
+        RRP_METRIC_RECORD(QUEUE_HEAP_DEPTH, depth);
+        RRP_METRIC_TIMER(timer, PATH_LATENCY);   // records the scope's duration in ns
+*/
+#ifdef RRP_METRICS
+constexpr bool METRICS_ENABLED = true;
+#define RRP_METRIC_ADD(counter, n) ::metrics::add(::metrics::counter, static_cast<std::uint64_t>(n))
+#define RRP_METRIC_RECORD(histogram, value) ::metrics::record(::metrics::histogram, static_cast<std::uint64_t>(value))
+#define RRP_METRIC_TIMER(name, histogram) ::metrics::ScopedTimer name(::metrics::histogram)
+#else
+constexpr bool METRICS_ENABLED = false;
+#define RRP_METRIC_ADD(counter, n) ((void)sizeof(n))
+#define RRP_METRIC_RECORD(histogram, value) ((void)sizeof(value))
+#define RRP_METRIC_TIMER(name, histogram) ((void)0)
+#endif
+
+namespace metrics {
+
+enum Counter {
+    PATH_QUERIES,               // findOptimalPath calls
+    PATH_NOT_FOUND,             // ... that found no route
+    PATH_NODES_SETTLED,         // nodes taken off the heap by any route search
+    PATH_EDGES_RELAXED,         // edges that improved a tentative distance
+    CACHED_PATH_QUERIES,        // findCachedPath calls
+    QUEUE_PUSHES,
+    QUEUE_POPS,
+    QUEUE_PRIORITY_UPDATES,
+    QUEUE_SIFT_SWAPS,           // levels moved by heapifyUp / heapifyDown
+    ALLOCATIONS_SUCCEEDED,      // ResourceManager::allocateResources
+    ALLOCATIONS_FAILED,
+    TRANSFERS_SUCCEEDED,        // transferResources and relocateStock
+    TRANSFERS_FAILED,
+    SHIPMENTS_DISPATCHED,       // ShipmentScheduler::dispatch that found a route
+    SHIPMENTS_DELIVERED,
+    LOG_RECORDS,                // EventLogger::log calls that were written or queued
+    LOG_BYTES,
+    COUNTER_COUNT
+};
+
+enum Histogram {
+    PATH_LATENCY,               // ns per findOptimalPath
+    CACHED_PATH_LATENCY,        // ns per findCachedPath
+    ALLOCATION_LATENCY,         // ns per allocateResources
+    LOG_LATENCY,                // ns per EventLogger::log (caller side)
+    QUEUE_HEAP_DEPTH,           // heap levels after each push
+    HISTOGRAM_COUNT
+};
+
+struct MetricInfo {
+    const char* name;           // export name, without the rrp_ prefix
+    const char* help;
+    double scale;               // multiplies recorded values into the export unit
+};
+
+inline const MetricInfo& counterInfo(Counter c) {
+    static const MetricInfo table[COUNTER_COUNT] = {
+        { "path_queries_total", "findOptimalPath calls", 1 },
+        { "path_not_found_total", "findOptimalPath calls without a route", 1 },
+        { "path_nodes_settled_total", "Nodes settled by route searches", 1 },
+        { "path_edges_relaxed_total", "Edges relaxed by route searches", 1 },
+        { "cached_path_queries_total", "findCachedPath calls", 1 },
+        { "queue_pushes_total", "Requests added to the priority queue", 1 },
+        { "queue_pops_total", "Requests taken off the priority queue", 1 },
+        { "queue_priority_updates_total", "Priority changes in the queue", 1 },
+        { "queue_sift_swaps_total", "Heap levels moved while sifting", 1 },
+        { "allocations_succeeded_total", "Successful allocateResources calls", 1 },
+        { "allocations_failed_total", "Failed allocateResources calls", 1 },
+        { "transfers_succeeded_total", "Successful stock transfers between locations", 1 },
+        { "transfers_failed_total", "Failed stock transfers between locations", 1 },
+        { "shipments_dispatched_total", "Shipments sent on their way", 1 },
+        { "shipments_delivered_total", "Shipments that arrived at their target", 1 },
+        { "log_records_total", "Log records written or queued", 1 },
+        { "log_bytes_total", "Bytes of log messages", 1 },
+    };
+    return table[c];
+}
+
+inline const MetricInfo& histogramInfo(Histogram h) {
+    static const MetricInfo table[HISTOGRAM_COUNT] = {
+        { "path_latency_seconds", "Time per findOptimalPath call", 1e-9 },
+        { "cached_path_latency_seconds", "Time per findCachedPath call", 1e-9 },
+        { "allocation_latency_seconds", "Time per allocateResources call", 1e-9 },
+        { "log_latency_seconds", "Time per EventLogger::log call", 1e-9 },
+        { "queue_heap_depth", "Priority queue heap depth after a push", 1 },
+    };
+    return table[h];
+}
+
+/*
+    Bucket layout of the histograms: values below 16 get a bucket each, above
+    that every power of two is split into 16 equal buckets, so any value is
+    known to within 1/16 (6%) over the whole 64-bit range, in 976 buckets.
+*/
+namespace buckets {
+    constexpr int SUB_BITS = 4;
+    constexpr int SUB_COUNT = 1 << SUB_BITS;
+    constexpr int COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    inline int highestBit(std::uint64_t v) {
+        int bit = 0;
+        for (int step = 32; step > 0; step >>= 1) {
+            if (v >> (bit + step)) bit += step;
+        }
+        return bit;
+    }
+
+    inline int indexOf(std::uint64_t v) {
+        if (v < static_cast<std::uint64_t>(SUB_COUNT)) return static_cast<int>(v);
+        int exponent = highestBit(v);
+        return (exponent - SUB_BITS + 1) * SUB_COUNT + static_cast<int>((v >> (exponent - SUB_BITS)) & (SUB_COUNT - 1));
+    }
+
+    // Smallest value that falls into bucket `index`
+    inline std::uint64_t lowerBound(int index) {
+        if (index < SUB_COUNT) return static_cast<std::uint64_t>(index);
+        int exponent = index / SUB_COUNT + SUB_BITS - 1;
+        return static_cast<std::uint64_t>(SUB_COUNT + index % SUB_COUNT) << (exponent - SUB_BITS);
+    }
+
+    inline std::uint64_t upperBound(int index) {
+        return index + 1 < COUNT ? lowerBound(index + 1) - 1 : UINT64_MAX;
+    }
+}
+
+// Adds to a value only the owning thread writes; readers on other threads see whole values
+inline void bump(std::atomic<std::uint64_t>& value, std::uint64_t n) {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+struct HistogramCells {
+    std::array<std::atomic<std::uint64_t>, buckets::COUNT> bucket{};
+    std::atomic<std::uint64_t> count{ 0 }, sum{ 0 }, max{ 0 };
+
+    void record(std::uint64_t v) {
+        bump(bucket[buckets::indexOf(v)], 1);
+        bump(count, 1);
+        bump(sum, v);
+        if (v > max.load(std::memory_order_relaxed)) max.store(v, std::memory_order_relaxed);
+    }
+};
+
+// One thread's metrics
+struct ThreadMetrics {
+    std::array<std::atomic<std::uint64_t>, COUNTER_COUNT> counters{};
+    std::array<HistogramCells, HISTOGRAM_COUNT> histograms;
+};
+
+// Merged view of a histogram
+struct HistogramSummary {
+    std::uint64_t count = 0, sum = 0, max = 0;
+    std::vector<std::uint64_t> bucket = std::vector<std::uint64_t>(buckets::COUNT, 0);
+
+    double mean() const { return count > 0 ? static_cast<double>(sum) / count : 0.0; }
+
+    // Value at quantile q (0..1): the top of the bucket holding that rank, never above the max
+    std::uint64_t quantile(double q) const {
+        if (count == 0) return 0;
+        std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(std::min(1.0, std::max(0.0, q)) * count));
+        if (rank == 0) rank = 1;
+        std::uint64_t seen = 0;
+        for (int i = 0; i < buckets::COUNT; ++i) {
+            seen += bucket[i];
+            if (seen >= rank) return std::min(max, buckets::upperBound(i));
+        }
+        return max;
+    }
+};
+
+struct MetricsSnapshot {
+    bool enabled = METRICS_ENABLED;
+    double seconds = 0;         // since the registry was created or last reset
+    std::array<std::uint64_t, COUNTER_COUNT> counters{};
+    std::array<HistogramSummary, HISTOGRAM_COUNT> histograms;
+};
+
+class MetricsRegistry {
+    using Clock = std::chrono::steady_clock;
+
+    mutable std::mutex mutex;
+    std::vector<ThreadMetrics*> live;
+    ThreadMetrics retired;      // totals of threads that have exited
+    Clock::time_point since = Clock::now();
+
+    // Lives in thread-local storage: registers the thread's block, folds it in on thread exit
+    struct ThreadHandle {
+        ThreadMetrics metrics;
+        MetricsRegistry& registry;
+
+        explicit ThreadHandle(MetricsRegistry& r) : registry(r) {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.live.push_back(&metrics);
+        }
+        ~ThreadHandle() {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            merge(metrics, registry.retired);
+            registry.live.erase(std::find(registry.live.begin(), registry.live.end(), &metrics));
+        }
+    };
+
+    static void merge(const ThreadMetrics& from, ThreadMetrics& into) {
+        for (int c = 0; c < COUNTER_COUNT; ++c) {
+            bump(into.counters[c], from.counters[c].load(std::memory_order_relaxed));
+        }
+        for (int h = 0; h < HISTOGRAM_COUNT; ++h) {
+            const HistogramCells& src = from.histograms[h];
+            HistogramCells& dst = into.histograms[h];
+            for (int i = 0; i < buckets::COUNT; ++i) bump(dst.bucket[i], src.bucket[i].load(std::memory_order_relaxed));
+            bump(dst.count, src.count.load(std::memory_order_relaxed));
+            bump(dst.sum, src.sum.load(std::memory_order_relaxed));
+            std::uint64_t m = src.max.load(std::memory_order_relaxed);
+            if (m > dst.max.load(std::memory_order_relaxed)) dst.max.store(m, std::memory_order_relaxed);
+        }
+    }
+
+    static void addInto(const ThreadMetrics& from, MetricsSnapshot& s) {
+        for (int c = 0; c < COUNTER_COUNT; ++c) s.counters[c] += from.counters[c].load(std::memory_order_relaxed);
+        for (int h = 0; h < HISTOGRAM_COUNT; ++h) {
+            const HistogramCells& src = from.histograms[h];
+            HistogramSummary& dst = s.histograms[h];
+            for (int i = 0; i < buckets::COUNT; ++i) dst.bucket[i] += src.bucket[i].load(std::memory_order_relaxed);
+            dst.count += src.count.load(std::memory_order_relaxed);
+            dst.sum += src.sum.load(std::memory_order_relaxed);
+            dst.max = std::max(dst.max, src.max.load(std::memory_order_relaxed));
+        }
+    }
+
+    static void clear(ThreadMetrics& m) {
+        for (auto& c : m.counters) c.store(0, std::memory_order_relaxed);
+        for (HistogramCells& h : m.histograms) {
+            for (auto& b : h.bucket) b.store(0, std::memory_order_relaxed);
+            h.count.store(0, std::memory_order_relaxed);
+            h.sum.store(0, std::memory_order_relaxed);
+            h.max.store(0, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    static MetricsRegistry& instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    // The calling thread's block (registered on first use)
+    ThreadMetrics& local() {
+        thread_local ThreadHandle handle(*this);
+        return handle.metrics;
+    }
+
+    MetricsSnapshot snapshot() const {
+        MetricsSnapshot s;
+        std::lock_guard<std::mutex> lock(mutex);
+        s.seconds = std::chrono::duration<double>(Clock::now() - since).count();
+        addInto(retired, s);
+        for (const ThreadMetrics* m : live) addInto(*m, s);
+        return s;
+    }
+
+    // Zeroes everything; call while no instrumented work is running
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        clear(retired);
+        for (ThreadMetrics* m : live) clear(*m);
+        since = Clock::now();
+    }
+};
+
+inline void add(Counter c, std::uint64_t n) {
+    bump(MetricsRegistry::instance().local().counters[c], n);
+}
+
+inline void record(Histogram h, std::uint64_t value) {
+    MetricsRegistry::instance().local().histograms[h].record(value);
+}
+
+// Records the lifetime of the scope, in nanoseconds
+class ScopedTimer {
+    Histogram histogram;
+    std::chrono::steady_clock::time_point started;
+
+public:
+    explicit ScopedTimer(Histogram h) : histogram(h), started(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count();
+        record(histogram, static_cast<std::uint64_t>(ns > 0 ? ns : 0));
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+// Heap levels of a binary heap with `size` entries
+inline int heapDepth(size_t size) {
+    return size == 0 ? 0 : buckets::highestBit(size) + 1;
+}
+
+enum class ExportFormat { PROMETHEUS, JSON };
+
+// .json files get JSON, everything else the Prometheus text format
+inline ExportFormat formatForFile(const std::string& filename) {
+    const std::string suffix = ".json";
+    bool json = filename.size() >= suffix.size() &&
+        filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+    return json ? ExportFormat::JSON : ExportFormat::PROMETHEUS;
+}
+
+/*
+    Prometheus text exposition format: counters as *_total, histograms as
+    summaries (p50/p90/p99/p99.9, _sum, _count) in seconds for latencies.
+*/
+inline std::string toPrometheus(const MetricsSnapshot& s) {
+    static const double QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+    std::ostringstream out;
+    out << std::setprecision(9);
+    out << "# HELP rrp_metrics_enabled Whether the build has instrumentation compiled in\n"
+        << "# TYPE rrp_metrics_enabled gauge\n"
+        << "rrp_metrics_enabled " << (s.enabled ? 1 : 0) << "\n"
+        << "# HELP rrp_metrics_window_seconds Time covered by these metrics\n"
+        << "# TYPE rrp_metrics_window_seconds gauge\n"
+        << "rrp_metrics_window_seconds " << s.seconds << "\n";
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        const MetricInfo& info = counterInfo(static_cast<Counter>(c));
+        out << "# HELP rrp_" << info.name << " " << info.help << "\n"
+            << "# TYPE rrp_" << info.name << " counter\n"
+            << "rrp_" << info.name << " " << s.counters[c] << "\n";
+    }
+    for (int h = 0; h < HISTOGRAM_COUNT; ++h) {
+        const MetricInfo& info = histogramInfo(static_cast<Histogram>(h));
+        const HistogramSummary& summary = s.histograms[h];
+        out << "# HELP rrp_" << info.name << " " << info.help << "\n"
+            << "# TYPE rrp_" << info.name << " summary\n";
+        for (double q : QUANTILES) {
+            out << "rrp_" << info.name << "{quantile=\"" << q << "\"} " << summary.quantile(q) * info.scale << "\n";
+        }
+        out << "rrp_" << info.name << "_sum " << summary.sum * info.scale << "\n"
+            << "rrp_" << info.name << "_count " << summary.count << "\n";
+    }
+    return out.str();
+}
+
+// JSON summary: totals and rates of the counters, count/mean/percentiles/max of the histograms
+inline std::string toJson(const MetricsSnapshot& s) {
+    std::ostringstream out;
+    out << std::setprecision(9);
+    out << "{\n  \"enabled\": " << (s.enabled ? "true" : "false") << ",\n"
+        << "  \"seconds\": " << s.seconds << ",\n  \"counters\": {";
+    for (int c = 0; c < COUNTER_COUNT; ++c) {
+        const MetricInfo& info = counterInfo(static_cast<Counter>(c));
+        out << (c ? "," : "") << "\n    \"" << info.name << "\": { \"value\": " << s.counters[c]
+            << ", \"per_second\": " << (s.seconds > 0 ? s.counters[c] / s.seconds : 0.0) << " }";
+    }
+    out << "\n  },\n  \"histograms\": {";
+    for (int h = 0; h < HISTOGRAM_COUNT; ++h) {
+        const MetricInfo& info = histogramInfo(static_cast<Histogram>(h));
+        const HistogramSummary& summary = s.histograms[h];
+        out << (h ? "," : "") << "\n    \"" << info.name << "\": { \"count\": " << summary.count
+            << ", \"sum\": " << summary.sum * info.scale
+            << ", \"mean\": " << summary.mean() * info.scale
+            << ", \"p50\": " << summary.quantile(0.5) * info.scale
+            << ", \"p90\": " << summary.quantile(0.9) * info.scale
+            << ", \"p99\": " << summary.quantile(0.99) * info.scale
+            << ", \"p999\": " << summary.quantile(0.999) * info.scale
+            << ", \"max\": " << summary.max * info.scale << " }";
+    }
+    out << "\n  }\n}\n";
+    return out.str();
+}
+
+// Writes a snapshot in the format matching the file name; false if the file can't be written
+inline bool writeSnapshot(const std::string& filename, const MetricsSnapshot& s) {
+    std::ofstream out(filename);
+    if (!out) return false;
+    out << (formatForFile(filename) == ExportFormat::JSON ? toJson(s) : toPrometheus(s));
+    return static_cast<bool>(out);
+}
+
+} // namespace metrics
@@ -0,0 +1,182 @@
+// DSA concept used = Multi-commodity flow (successive shortest paths with path splitting)
+
+#pragma once
+#include "TransportationNetwork.h"
+#include "ResourceTypeRegistry.h"
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <cmath>
+
+// One commodity of a batch: move `quantity` units from source to target
+struct FlowDemand {
+    int requestId;
+    int sourceLocationId;
+    int targetLocationId;
+    ResourceTypeId resourceType;
+    int quantity;
+    double loadPerUnit;      // edge load one unit adds (the resource's weight)
+};
+
+// `quantity` units sent along `path` (location IDs, source first)
+struct FlowPath {
+    std::vector<int> path;
+    std::vector<int> edges;  // CSR edge handles along the path (valid for FlowPlan::layout)
+    int quantity = 0;
+    int load = 0;            // edge load the path adds on each of its routes
+};
+
+// What the planner decided for one demand
+struct FlowAssignment {
+    size_t demandIndex = 0;
+    int requestId = 0;
+    int requested = 0;
+    int planned = 0;         // sum of the path quantities (<= requested)
+    int committed = 0;       // filled in by ResourceManager::commitTransferPlan
+    long long cost = 0;      // sum over paths of (route cost * path quantity)
+    std::vector<FlowPath> paths;
+
+    bool fullyPlanned() const { return planned == requested; }
+};
+
+struct FlowPlan {
+    std::vector<FlowAssignment> assignments;   // same order as the demands
+    long long totalCost = 0;
+    int fullyPlannedCount = 0;
+    std::uint64_t networkVersion = 0;          // network version the plan was computed on
+    std::uint64_t layout = 0;                  // network layoutVersion() the edge handles belong to
+};
+
+struct FlowPlannerOptions {
+    int maxPathsPerDemand = 8;      // a demand is split over at most this many routes
+    // Extra cost per unit of relative load: an edge that is x% full costs
+    // cost * (1 + congestionWeight * x / 100) for later paths, which spreads
+    // a batch over parallel routes before they are saturated. 0 = plain cost.
+    double congestionWeight = 1.0;
+};
+
+/*
+    Plans a whole batch of transfers against the shared route capacities.
+
+    Demands are served one after another in the order given (callers pass them
+    in priority order). Each demand repeatedly takes the cheapest route that can
+    still carry at least one unit, sends as much as that route's tightest edge
+    allows and subtracts it from a residual copy of the capacities, until the
+    demand is met, no route is left, or maxPathsPerDemand routes are used. So a
+    shipment that does not fit one route is split across several instead of
+    being rejected.
+
+    This is successive shortest paths without flow cancellation between
+    commodities, i.e. a greedy approximation of min-cost multi-commodity flow
+    that respects every capacity. The network is only read; nothing is
+    committed until ResourceManager::commitTransferPlan.
+*/
+class MultiCommodityFlowPlanner {
+    // CSR graph as seen through the residual capacities, for runAStar
+    struct ResidualView {
+        const std::vector<int>& rowStart;
+        const std::vector<int>& to;
+        const std::vector<int>& residual;     // INT_MIN for unusable edges
+
+        int nodeCount() const { return static_cast<int>(rowStart.size()) - 1; }
+        bool canAddLoad(int e, int load) const { return residual[e] != INT_MIN && residual[e] >= load; }
+    };
+
+    std::vector<int> residual;
+    std::vector<int> weight;
+    std::vector<int> edgesOnPath;
+
+    static int loadFor(int units, double loadPerUnit) {
+        return static_cast<int>(units * loadPerUnit);
+    }
+
+    // Largest number of units whose load fits into `room`
+    static int unitsFitting(int room, double loadPerUnit, int wanted) {
+        if (loadPerUnit <= 0) return wanted;
+        long long units = static_cast<long long>(std::floor(room / loadPerUnit));
+        if (units > wanted) units = wanted;
+        while (units > 0 && loadFor(static_cast<int>(units), loadPerUnit) > room) --units;
+        return static_cast<int>(units);
+    }
+
+    void updateWeight(const CsrGraph& g, int e, double congestionWeight) {
+        if (congestionWeight <= 0 || g.capacity[e] <= 0) return;
+        double used = 1.0 - static_cast<double>(residual[e]) / g.capacity[e];
+        weight[e] = static_cast<int>(g.cost[e] * (1.0 + congestionWeight * std::max(0.0, used)));
+    }
+
+public:
+    FlowPlan plan(const TransportationNetwork& network, const std::vector<FlowDemand>& demands,
+        const FlowPlannerOptions& options = FlowPlannerOptions()) {
+        const CsrGraph& g = network.graph();
+        int m = g.edgeCount();
+        residual.resize(m);
+        weight.resize(m);
+        for (int e = 0; e < m; ++e) {
+            residual[e] = g.loadLimit(e);
+            weight[e] = g.cost[e];
+            if (residual[e] != INT_MIN) updateWeight(g, e, options.congestionWeight);
+        }
+
+        FlowPlan result;
+        result.networkVersion = network.version();
+        result.layout = network.layoutVersion();
+        result.assignments.resize(demands.size());
+        ResidualView view{ g.rowStart, g.to, residual };
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+
+        for (size_t d = 0; d < demands.size(); ++d) {
+            const FlowDemand& demand = demands[d];
+            FlowAssignment& out = result.assignments[d];
+            out.demandIndex = d;
+            out.requestId = demand.requestId;
+            out.requested = demand.quantity;
+
+            int src = network.indexOf(demand.sourceLocationId);
+            int dst = network.indexOf(demand.targetLocationId);
+            if (src < 0 || dst < 0 || src == dst || demand.quantity <= 0) continue;
+
+            int remaining = demand.quantity;
+            int oneUnit = std::max(1, loadFor(1, demand.loadPerUnit));
+            while (remaining > 0 && static_cast<int>(out.paths.size()) < options.maxPathsPerDemand) {
+                runAStar(view, weight, ws, src, dst, oneUnit, [](int) { return 0; });
+                if (!ws.reached(dst)) break;
+
+                // Bottleneck of the route, in units
+                edgesOnPath.clear();
+                int room = INT_MAX;
+                for (int v = dst; v != src; v = ws.predecessor(v)) {
+                    int e = ws.predecessorEdge(v);
+                    edgesOnPath.push_back(e);
+                    room = std::min(room, residual[e]);
+                }
+                int units = unitsFitting(room, demand.loadPerUnit, remaining);
+                if (units <= 0) break;
+
+                FlowPath fp;
+                fp.quantity = units;
+                fp.load = loadFor(units, demand.loadPerUnit);
+                long long routeCost = 0;
+                fp.path.reserve(edgesOnPath.size() + 1);
+                fp.edges.assign(edgesOnPath.rbegin(), edgesOnPath.rend());
+                fp.path.push_back(demand.sourceLocationId);
+                for (auto it = edgesOnPath.rbegin(); it != edgesOnPath.rend(); ++it) {
+                    int e = *it;
+                    residual[e] -= fp.load;
+                    routeCost += g.cost[e];
+                    updateWeight(g, e, options.congestionWeight);
+                    fp.path.push_back(network.idAt(g.to[e]));
+                }
+
+                out.cost += routeCost * units;
+                out.planned += units;
+                remaining -= units;
+                out.paths.push_back(std::move(fp));
+            }
+
+            result.totalCost += out.cost;
+            if (out.fullyPlanned()) ++result.fullyPlannedCount;
+        }
+        return result;
+    }
+};
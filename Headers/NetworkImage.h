@@ -0,0 +1,543 @@
+// DSA concept used = Memory-mapped flat arrays (the file layout is the in-memory CSR layout)
+
+#pragma once
+#include "MappedFile.h"
+#include "TransportationNetwork.h"
+#include "ResourceManager.h"
+#include "SearchWorkspace.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+/*
+    Binary image of a network and its inventory: locations, routes, central
+    resources and per-location stock and thresholds.
+
+    File layout: a fixed Header with a table of sections, then the sections,
+    each starting on an 8-byte boundary. Every section is a flat array in
+    native byte order; the route sections are exactly the CsrGraph columns
+    (rowStart, to, cost, ... one value per edge), so a mapped image can be
+    routed on in place and loading it into a network is a handful of bulk
+    copies with no per-edge parsing. Variable-length names live in one STRINGS
+    blob and are referenced by (offset, length). Resource types are stored by
+    name (RESOURCE_TYPE_NAMES) and re-interned on load, like the journal does.
+    The header records the byte order; an image is only read on a machine
+    with the byte order it was written with.
+*/
+namespace network_image_format {
+    constexpr char MAGIC[4] = { 'R', 'R', 'P', 'N' };
+    constexpr std::uint32_t VERSION = 1;
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    enum Section : std::uint32_t {
+        ROW_START,              // int32[nodes + 1]
+        EDGE_TO,                // int32[edges], dense node index
+        EDGE_COST,              // int32[edges]
+        EDGE_CAPACITY,          // int32[edges]
+        EDGE_LOAD,              // int32[edges]
+        EDGE_DISTANCE,          // double[edges]
+        EDGE_ROUTE_TYPE,        // uint8[edges], index into ROUTE_TYPE_NAMES
+        EDGE_OPERATIONAL,       // uint64[(edges + 63) / 64], one bit per edge
+        EDGE_TWIN,              // int32[edges], reverse edge
+        NODE_OPEN,              // uint8[nodes]
+        NODE_IDS,               // int32[nodes], dense index -> location ID
+        NODE_LOOKUP,            // NodeLookup[nodes], sorted by location ID
+        LOCATIONS,              // LocationRecord[locations], sorted by ID
+        LOCATION_STOCK,         // int32[locations * resourceTypes]
+        LOCATION_CRITICAL,      // int32[locations * resourceTypes]
+        RESOURCES,              // ResourceRecord[resources]
+        ROUTE_TYPE_NAMES,       // StringRef[routeTypes]
+        RESOURCE_TYPE_NAMES,    // StringRef[resourceTypes]
+        STRINGS,                // char[]
+        SECTION_COUNT
+    };
+
+    struct SectionEntry {
+        std::uint64_t offset;
+        std::uint64_t bytes;
+    };
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t headerBytes;
+        std::int32_t nodeCount;
+        std::int32_t edgeCount;
+        std::int32_t locationCount;
+        std::int32_t resourceCount;
+        std::int32_t routeTypeCount;
+        std::int32_t resourceTypeCount;
+        std::uint64_t fileBytes;
+        SectionEntry sections[SECTION_COUNT];
+    };
+
+    struct StringRef {
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    struct NodeLookup {
+        std::int32_t id;
+        std::int32_t index;
+    };
+
+    struct LocationRecord {
+        std::int32_t id;
+        std::int32_t maxCapacity;
+        std::int32_t currentOccupancy;
+        std::uint8_t operational;
+        std::uint8_t reserved[3];
+        double latitude;
+        double longitude;
+        StringRef name;
+        std::uint64_t stockedTypes;     // bit per resource type index that was ever stocked
+    };
+
+    struct ResourceRecord {
+        std::uint32_t typeIndex;        // into RESOURCE_TYPE_NAMES
+        std::int32_t total;
+        std::int32_t allocated;
+        std::int32_t expiryDate;
+        std::int32_t criticalLevel;
+        std::int32_t reserved;
+        double unitCost;
+        double weight;
+    };
+
+    inline std::uint64_t alignUp(std::uint64_t offset) { return (offset + 7) & ~std::uint64_t(7); }
+}
+
+/*
+    A mapped network image. open() only checks the header and the section
+    table, so it costs the same for any network size; pages are read when
+    touched. The image can be queried directly (findOptimalPath runs on the
+    mapped arrays), or copied into a TransportationNetwork and ResourceManager
+    with restore() to get a live, mutable system.
+*/
+class NetworkImage {
+    using Header = network_image_format::Header;
+    using Section = network_image_format::Section;
+    using StringRef = network_image_format::StringRef;
+    using NodeLookup = network_image_format::NodeLookup;
+    using LocationRecord = network_image_format::LocationRecord;
+    using ResourceRecord = network_image_format::ResourceRecord;
+
+    MappedFile file;
+    const Header* header = nullptr;
+
+    const int* capacity = nullptr;
+    const int* currentLoad = nullptr;
+    const double* distance = nullptr;
+    const std::uint8_t* routeType = nullptr;
+    const std::uint64_t* operationalBits = nullptr;
+    const int* twin = nullptr;
+    const std::uint8_t* nodeOpen = nullptr;
+    const int* nodeIds = nullptr;
+    const NodeLookup* lookup = nullptr;
+    const LocationRecord* locationRecords = nullptr;
+    const int* locationStock = nullptr;
+    const int* locationCritical = nullptr;
+    const ResourceRecord* resourceRecords = nullptr;
+    const StringRef* routeTypeNames = nullptr;
+    const StringRef* resourceTypeNames = nullptr;
+    const char* strings = nullptr;
+
+    template <typename T>
+    const T* sectionData(Section s) const {
+        return reinterpret_cast<const T*>(file.data() + header->sections[s].offset);
+    }
+
+    // Byte size each section must have for the counts in the header (STRINGS: any)
+    static std::uint64_t expectedBytes(const Header& h, Section s) {
+        using namespace network_image_format;
+        std::uint64_t n = static_cast<std::uint64_t>(h.nodeCount);
+        std::uint64_t e = static_cast<std::uint64_t>(h.edgeCount);
+        std::uint64_t l = static_cast<std::uint64_t>(h.locationCount);
+        std::uint64_t t = static_cast<std::uint64_t>(h.resourceTypeCount);
+        switch (s) {
+        case ROW_START: return (n + 1) * sizeof(std::int32_t);
+        case EDGE_TO: case EDGE_COST: case EDGE_CAPACITY: case EDGE_LOAD: case EDGE_TWIN:
+            return e * sizeof(std::int32_t);
+        case EDGE_DISTANCE: return e * sizeof(double);
+        case EDGE_ROUTE_TYPE: return e;
+        case EDGE_OPERATIONAL: return (e + 63) / 64 * sizeof(std::uint64_t);
+        case NODE_OPEN: return n;
+        case NODE_IDS: return n * sizeof(std::int32_t);
+        case NODE_LOOKUP: return n * sizeof(NodeLookup);
+        case LOCATIONS: return l * sizeof(LocationRecord);
+        case LOCATION_STOCK: case LOCATION_CRITICAL: return l * t * sizeof(std::int32_t);
+        case RESOURCES: return static_cast<std::uint64_t>(h.resourceCount) * sizeof(ResourceRecord);
+        case ROUTE_TYPE_NAMES: return static_cast<std::uint64_t>(h.routeTypeCount) * sizeof(StringRef);
+        case RESOURCE_TYPE_NAMES: return t * sizeof(StringRef);
+        default: return 0;
+        }
+    }
+
+    bool validString(const StringRef& s) const {
+        return static_cast<std::uint64_t>(s.offset) + s.length <= header->sections[network_image_format::STRINGS].bytes;
+    }
+
+    std::string stringAt(const StringRef& s) const { return std::string(strings + s.offset, s.length); }
+
+    void pathTo(const SearchWorkspace& ws, int dst, std::vector<int>& path) const {
+        for (int at = dst; at >= 0; at = ws.predecessor(at)) path.push_back(nodeIds[at]);
+        std::reverse(path.begin(), path.end());
+    }
+
+public:
+    // Route columns, read by the shortest-path templates straight from the mapping
+    const int* rowStart = nullptr;
+    const int* to = nullptr;
+    const int* cost = nullptr;
+
+    NetworkImage() = default;
+    NetworkImage(const NetworkImage&) = delete;
+    NetworkImage& operator=(const NetworkImage&) = delete;
+
+    /*
+        Maps an image and checks its header and section table. False if the
+        file is missing, not an image, of another version or byte order, or
+        truncated. Call verify() as well before trusting a file from elsewhere.
+    */
+    bool open(const std::string& filename) {
+        using namespace network_image_format;
+        close();
+        if (!file.open(filename) || file.size() < sizeof(Header)) {
+            close();
+            return false;
+        }
+        const Header* h = reinterpret_cast<const Header*>(file.data());
+        bool ok = std::memcmp(h->magic, MAGIC, 4) == 0 && h->version == VERSION &&
+            h->byteOrder == BYTE_ORDER_MARK && h->headerBytes == sizeof(Header) && h->fileBytes == file.size() &&
+            h->nodeCount >= 0 && h->edgeCount >= 0 && h->locationCount >= 0 && h->resourceCount >= 0 &&
+            h->routeTypeCount >= 0 && h->routeTypeCount <= UINT8_MAX + 1 &&
+            h->resourceTypeCount >= 0 && h->resourceTypeCount <= MAX_RESOURCE_TYPES;
+        for (int s = 0; ok && s < static_cast<int>(SECTION_COUNT); ++s) {
+            const SectionEntry& entry = h->sections[s];
+            ok = entry.offset % 8 == 0 && entry.offset >= sizeof(Header) && entry.offset <= file.size() &&
+                entry.bytes <= file.size() - entry.offset &&
+                (s == STRINGS || entry.bytes == expectedBytes(*h, static_cast<Section>(s)));
+        }
+        if (!ok) {
+            close();
+            return false;
+        }
+
+        header = h;
+        rowStart = sectionData<int>(ROW_START);
+        to = sectionData<int>(EDGE_TO);
+        cost = sectionData<int>(EDGE_COST);
+        capacity = sectionData<int>(EDGE_CAPACITY);
+        currentLoad = sectionData<int>(EDGE_LOAD);
+        distance = sectionData<double>(EDGE_DISTANCE);
+        routeType = sectionData<std::uint8_t>(EDGE_ROUTE_TYPE);
+        operationalBits = sectionData<std::uint64_t>(EDGE_OPERATIONAL);
+        twin = sectionData<int>(EDGE_TWIN);
+        nodeOpen = sectionData<std::uint8_t>(NODE_OPEN);
+        nodeIds = sectionData<int>(NODE_IDS);
+        lookup = sectionData<NodeLookup>(NODE_LOOKUP);
+        locationRecords = sectionData<LocationRecord>(LOCATIONS);
+        locationStock = sectionData<int>(LOCATION_STOCK);
+        locationCritical = sectionData<int>(LOCATION_CRITICAL);
+        resourceRecords = sectionData<ResourceRecord>(RESOURCES);
+        routeTypeNames = sectionData<StringRef>(ROUTE_TYPE_NAMES);
+        resourceTypeNames = sectionData<StringRef>(RESOURCE_TYPE_NAMES);
+        strings = sectionData<char>(STRINGS);
+        if (rowStart[0] != 0 || rowStart[h->nodeCount] != h->edgeCount) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        file.close();
+        header = nullptr;
+        rowStart = to = cost = nullptr;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+
+    /*
+        Full consistency check of the arrays (row offsets, node and edge
+        references, twins, names), O(nodes + edges). restore() runs it.
+    */
+    bool verify() const {
+        if (!isOpen()) return false;
+        const int n = header->nodeCount, m = header->edgeCount;
+        for (int u = 0; u < n; ++u) {
+            if (rowStart[u + 1] < rowStart[u]) return false;
+        }
+        for (int e = 0; e < m; ++e) {
+            if (to[e] < 0 || to[e] >= n || twin[e] < 0 || twin[e] >= m || twin[twin[e]] != e) return false;
+            if (routeType[e] >= header->routeTypeCount) return false;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (lookup[i].index < 0 || lookup[i].index >= n || nodeIds[lookup[i].index] != lookup[i].id) return false;
+            if (i > 0 && lookup[i - 1].id >= lookup[i].id) return false;
+        }
+        for (int i = 0; i < header->locationCount; ++i) {
+            if (!validString(locationRecords[i].name)) return false;
+            if (i > 0 && locationRecords[i - 1].id >= locationRecords[i].id) return false;
+        }
+        for (int i = 0; i < header->resourceCount; ++i) {
+            if (resourceRecords[i].typeIndex >= static_cast<std::uint32_t>(header->resourceTypeCount)) return false;
+        }
+        for (int i = 0; i < header->routeTypeCount; ++i) {
+            if (!validString(routeTypeNames[i])) return false;
+        }
+        for (int i = 0; i < header->resourceTypeCount; ++i) {
+            if (!validString(resourceTypeNames[i])) return false;
+        }
+        return true;
+    }
+
+    int nodeCount() const { return header ? header->nodeCount : 0; }
+    int edgeCount() const { return header ? header->edgeCount : 0; }
+    int locationCount() const { return header ? header->locationCount : 0; }
+    int resourceCount() const { return header ? header->resourceCount : 0; }
+
+    // Dense node index of a location ID (binary search over NODE_LOOKUP), or -1
+    int indexOf(int id) const {
+        if (!header) return -1;
+        const NodeLookup* end = lookup + header->nodeCount;
+        const NodeLookup* it = std::lower_bound(lookup, end, id,
+            [](const NodeLookup& entry, int key) { return entry.id < key; });
+        return it != end && it->id == id ? it->index : -1;
+    }
+
+    int idAt(int index) const { return nodeIds[index]; }
+
+    bool isOperational(int e) const { return (operationalBits[e >> 6] >> (e & 63)) & 1u; }
+
+    // Same rules as CsrGraph, evaluated on the mapped columns
+    int loadLimit(int e) const {
+        return isOperational(e) && nodeOpen[to[e]] ? capacity[e] - currentLoad[e] : INT_MIN;
+    }
+
+    bool canAddLoad(int e, int additionalLoad) const {
+        return isOperational(e) && nodeOpen[to[e]] && currentLoad[e] + additionalLoad <= capacity[e];
+    }
+
+    // Same contract (and same route) as TransportationNetwork::findOptimalPath on the saved state
+    bool findOptimalPath(int source, int destination, int requiredCapacity, std::vector<int>& path) const {
+        path.clear();
+        int src = indexOf(source);
+        int dst = indexOf(destination);
+        if (src < 0 || dst < 0) return false;
+
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        runDijkstra(*this, ws, src, dst, requiredCapacity);
+        if (!ws.reached(dst)) return false;
+        pathTo(ws, dst, path);
+        return true;
+    }
+
+    /*
+        Copies the image into an empty network and the resource manager that
+        manages it (no locations or routes yet, no resources for the image's
+        types). The route columns are bulk-copied; locations, resources and
+        per-location thresholds go through the usual add calls so the spatial
+        index and critical-level tracking are set up too. Allocation history is
+        not part of an image. Returns false, leaving both untouched, if the
+        image fails verify() or the network is not empty.
+    */
+    bool restore(TransportationNetwork& network, ResourceManager& resourceManager) const {
+        if (!verify()) return false;
+        if (!network.locations.empty() || !network.nodeIds.empty() || !network.pendingEdges.empty()) return false;
+
+        const int n = header->nodeCount, m = header->edgeCount;
+        const int typeCount = header->resourceTypeCount;
+
+        // Image type indexes -> ids in this process
+        std::vector<ResourceTypeId> types(typeCount);
+        for (int t = 0; t < typeCount; ++t) types[t] = internResourceType(stringAt(resourceTypeNames[t]));
+        std::vector<RouteTypeId> routeTypes(header->routeTypeCount);
+        bool sameRouteTypes = true;
+        for (int r = 0; r < header->routeTypeCount; ++r) {
+            routeTypes[r] = network.routeTypes.intern(stringAt(routeTypeNames[r]));
+            sameRouteTypes = sameRouteTypes && routeTypes[r] == r;
+        }
+
+        CsrGraph& g = network.csr;
+        g.rowStart.assign(rowStart, rowStart + n + 1);
+        g.to.assign(to, to + m);
+        g.cost.assign(cost, cost + m);
+        g.capacity.assign(capacity, capacity + m);
+        g.currentLoad.assign(currentLoad, currentLoad + m);
+        g.distance.assign(distance, distance + m);
+        g.routeType.assign(routeType, routeType + m);
+        if (!sameRouteTypes) {
+            for (RouteTypeId& type : g.routeType) type = routeTypes[type];
+        }
+        g.operationalBits.assign(operationalBits, operationalBits + (m + 63) / 64);
+        g.twin.assign(twin, twin + m);
+        g.nodeOpen.assign(nodeOpen, nodeOpen + n);
+
+        network.nodeIds.assign(nodeIds, nodeIds + n);
+        network.nodeIndex.reserve(static_cast<size_t>(n));
+        for (int v = 0; v < n; ++v) network.nodeIndex.emplace(nodeIds[v], v);
+        ++network.changeVersion;
+        network.layoutChanged();
+
+        network.locations.reserve(static_cast<size_t>(header->locationCount));
+        for (int i = 0; i < header->locationCount; ++i) {
+            const LocationRecord& r = locationRecords[i];
+            Location loc(r.id, stringAt(r.name), r.latitude, r.longitude, r.operational != 0, r.maxCapacity);
+            loc.currentOccupancy = r.currentOccupancy;
+            for (int t = 0; t < typeCount; ++t) {
+                loc.addResource(types[t], locationStock[static_cast<size_t>(i) * typeCount + t]);
+                if ((r.stockedTypes >> t) & 1) loc.stockedTypes.fetch_or(std::uint64_t(1) << types[t]);
+            }
+            network.addLocation(loc);
+        }
+
+        for (int i = 0; i < header->resourceCount; ++i) {
+            const ResourceRecord& r = resourceRecords[i];
+            Resource res(stringAt(resourceTypeNames[r.typeIndex]), r.total, r.expiryDate, r.unitCost, r.weight,
+                r.criticalLevel);
+            if (r.allocated > 0) res.allocate(r.allocated);
+            resourceManager.addResource(res);
+        }
+
+        for (int i = 0; i < header->locationCount; ++i) {
+            for (int t = 0; t < typeCount; ++t) {
+                int level = locationCritical[static_cast<size_t>(i) * typeCount + t];
+                if (level > 0) resourceManager.setLocationCriticalLevel(locationRecords[i].id, types[t], level);
+            }
+        }
+        return true;
+    }
+
+    /*
+        Writes the current state of a network and its resource manager as an
+        image. Call it from the thread that changes the network. Returns false
+        if the file cannot be written.
+    */
+    static bool write(const std::string& filename, const TransportationNetwork& network,
+        const ResourceManager& resourceManager) {
+        using namespace network_image_format;
+        network.ensureFrozen();
+        const CsrGraph& g = network.csr;
+        const int n = static_cast<int>(network.nodeIds.size());
+        const int m = g.edgeCount();
+        const int typeCount = ResourceTypeRegistry::instance().size();
+
+        std::string blob;
+        auto addString = [&blob](const std::string& s) {
+            StringRef ref{ static_cast<std::uint32_t>(blob.size()), static_cast<std::uint32_t>(s.size()) };
+            blob += s;
+            return ref;
+        };
+
+        std::vector<int> rows = g.rowStart;
+        if (rows.empty()) rows.push_back(0);
+
+        std::vector<NodeLookup> nodes(n);
+        for (int v = 0; v < n; ++v) nodes[v] = { network.nodeIds[v], v };
+        std::sort(nodes.begin(), nodes.end(), [](const NodeLookup& a, const NodeLookup& b) { return a.id < b.id; });
+
+        std::vector<const Location*> sorted;
+        sorted.reserve(network.locations.size());
+        for (const auto& entry : network.locations) sorted.push_back(&entry.second);
+        std::sort(sorted.begin(), sorted.end(), [](const Location* a, const Location* b) { return a->id < b->id; });
+
+        std::vector<LocationRecord> locations(sorted.size());
+        std::vector<int> stock(sorted.size() * typeCount), critical(sorted.size() * typeCount);
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            const Location& loc = *sorted[i];
+            LocationRecord& r = locations[i];
+            std::memset(&r, 0, sizeof(r));
+            r.id = loc.id;
+            r.maxCapacity = loc.maxCapacity;
+            r.currentOccupancy = loc.currentOccupancy;
+            r.operational = loc.isOperational ? 1 : 0;
+            r.latitude = loc.latitude;
+            r.longitude = loc.longitude;
+            r.name = addString(loc.name);
+            r.stockedTypes = loc.stockedTypes.load(std::memory_order_acquire);
+            for (int t = 0; t < typeCount; ++t) {
+                stock[i * typeCount + t] = loc.getAvailableQuantity(static_cast<ResourceTypeId>(t));
+                critical[i * typeCount + t] = loc.criticalLevels[t];
+            }
+        }
+
+        std::vector<ResourceRecord> resources;
+        for (const Resource& res : resourceManager.getResources()) {
+            ResourceRecord r;
+            std::memset(&r, 0, sizeof(r));
+            r.typeIndex = res.typeId;
+            r.total = res.totalQuantity();
+            r.allocated = res.allocatedQuantity();
+            r.expiryDate = res.expiryDate;
+            r.criticalLevel = res.criticalLevel;
+            r.unitCost = res.unitCost;
+            r.weight = res.weight;
+            resources.push_back(r);
+        }
+
+        std::vector<StringRef> routeNames, typeNames;
+        for (size_t r = 0; r < network.routeTypes.size(); ++r) routeNames.push_back(addString(network.routeTypes.name(static_cast<RouteTypeId>(r))));
+        for (int t = 0; t < typeCount; ++t) typeNames.push_back(addString(resourceTypeName(static_cast<ResourceTypeId>(t))));
+
+        struct Chunk { const void* data; std::uint64_t bytes; };
+        Chunk chunks[SECTION_COUNT] = {
+            { rows.data(), rows.size() * sizeof(int) },
+            { g.to.data(), m * sizeof(int) },
+            { g.cost.data(), m * sizeof(int) },
+            { g.capacity.data(), m * sizeof(int) },
+            { g.currentLoad.data(), m * sizeof(int) },
+            { g.distance.data(), m * sizeof(double) },
+            { g.routeType.data(), static_cast<std::uint64_t>(m) },
+            { g.operationalBits.data(), g.operationalBits.size() * sizeof(std::uint64_t) },
+            { g.twin.data(), m * sizeof(int) },
+            { g.nodeOpen.data(), g.nodeOpen.size() },
+            { network.nodeIds.data(), n * sizeof(int) },
+            { nodes.data(), nodes.size() * sizeof(NodeLookup) },
+            { locations.data(), locations.size() * sizeof(LocationRecord) },
+            { stock.data(), stock.size() * sizeof(int) },
+            { critical.data(), critical.size() * sizeof(int) },
+            { resources.data(), resources.size() * sizeof(ResourceRecord) },
+            { routeNames.data(), routeNames.size() * sizeof(StringRef) },
+            { typeNames.data(), typeNames.size() * sizeof(StringRef) },
+            { blob.data(), blob.size() },
+        };
+
+        Header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, MAGIC, 4);
+        h.version = VERSION;
+        h.byteOrder = BYTE_ORDER_MARK;
+        h.headerBytes = sizeof(Header);
+        h.nodeCount = n;
+        h.edgeCount = m;
+        h.locationCount = static_cast<std::int32_t>(locations.size());
+        h.resourceCount = static_cast<std::int32_t>(resources.size());
+        h.routeTypeCount = static_cast<std::int32_t>(routeNames.size());
+        h.resourceTypeCount = typeCount;
+        std::uint64_t offset = alignUp(sizeof(Header));
+        for (int s = 0; s < static_cast<int>(SECTION_COUNT); ++s) {
+            h.sections[s] = { offset, chunks[s].bytes };
+            offset = alignUp(offset + chunks[s].bytes);
+        }
+        h.fileBytes = offset;
+
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        static const char padding[8] = {};
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        std::uint64_t written = sizeof(Header);
+        for (int s = 0; s < static_cast<int>(SECTION_COUNT); ++s) {
+            out.write(padding, static_cast<std::streamsize>(h.sections[s].offset - written));
+            if (chunks[s].bytes > 0) out.write(static_cast<const char*>(chunks[s].data), static_cast<std::streamsize>(chunks[s].bytes));
+            written = h.sections[s].offset + chunks[s].bytes;
+        }
+        out.write(padding, static_cast<std::streamsize>(h.fileBytes - written));
+        return static_cast<bool>(out);
+    }
+};
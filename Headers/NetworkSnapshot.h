@@ -0,0 +1,145 @@
+// DSA concept used = Persistent (copy-on-write) chunked arrays + reference-counted snapshots (RCU-style)
+
+#pragma once
+#include "SearchWorkspace.h"
+#include "PathQueries.h"
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+
+/*
+    The part of the network that only changes when routes are added (i.e. when
+    the CSR arrays are rebuilt). Every snapshot taken between two rebuilds
+    shares one instance.
+*/
+struct SnapshotTopology {
+    std::vector<int> rowStart;
+    std::vector<int> to;
+    std::vector<int> cost;
+    std::vector<int> capacity;
+    std::vector<int> nodeIds;                   // dense index -> location ID
+    std::unordered_map<int, int> nodeIndex;     // location ID -> dense index
+    std::uint64_t layout = 0;                   // TransportationNetwork::layoutVersion() it was built from
+};
+
+/*
+    Load state of EDGE_CHUNK_SIZE consecutive edges. A chunk is never modified
+    once published: a writer that changes an edge copies its chunk, so two
+    snapshots share every chunk nobody touched in between.
+*/
+struct EdgeStateChunk {
+    static constexpr int SHIFT = 8;
+    static constexpr int SIZE = 1 << SHIFT;
+
+    std::array<int, SIZE> currentLoad{};
+    std::array<int, SIZE> limit{};              // extra load the edge can take, INT_MIN if unusable
+};
+
+/*
+    Immutable view of the routes at one network version.
+
+    TransportationNetwork::snapshot() hands these out as shared_ptr<const ...>:
+    a reader keeps its snapshot alive for as long as it routes on it, and the
+    memory of an old version is freed when its last reader lets go, so the
+    writer never waits for readers and readers never take a lock. Any number of
+    threads can query the same snapshot while the live network keeps changing.
+
+    Only routing state is captured (routes, loads, route and location status);
+    inventories still live in the network's Location objects.
+
+    The members rowStart / to / cost and canAddLoad / loadLimit make a snapshot
+    a graph for runAStar, runWidestPath and yenKShortestPaths directly.
+*/
+class NetworkSnapshot {
+    std::shared_ptr<const SnapshotTopology> topology;
+    std::vector<std::shared_ptr<const EdgeStateChunk>> chunks;
+    std::shared_ptr<const std::vector<std::uint8_t>> open;   // per node: 0 while the location is offline
+    std::uint64_t changeVersion;
+
+    const EdgeStateChunk& chunkOf(int e) const { return *chunks[e >> EdgeStateChunk::SHIFT]; }
+
+    void pathTo(const SearchWorkspace& ws, int dst, std::vector<int>& path) const {
+        for (int at = dst; at >= 0; at = ws.predecessor(at)) path.push_back(topology->nodeIds[at]);
+        std::reverse(path.begin(), path.end());
+    }
+
+public:
+    const std::vector<int>& rowStart;
+    const std::vector<int>& to;
+    const std::vector<int>& cost;
+
+    NetworkSnapshot(std::shared_ptr<const SnapshotTopology> topology,
+        std::vector<std::shared_ptr<const EdgeStateChunk>> chunks,
+        std::shared_ptr<const std::vector<std::uint8_t>> open, std::uint64_t version)
+        : topology(std::move(topology)), chunks(std::move(chunks)), open(std::move(open)),
+        changeVersion(version),
+        rowStart(this->topology->rowStart), to(this->topology->to), cost(this->topology->cost) {
+    }
+
+    NetworkSnapshot(const NetworkSnapshot&) = delete;
+    NetworkSnapshot& operator=(const NetworkSnapshot&) = delete;
+
+    // TransportationNetwork::version() / layoutVersion() this snapshot shows
+    std::uint64_t version() const { return changeVersion; }
+    std::uint64_t layoutVersion() const { return topology->layout; }
+
+    // Pieces shared with the next snapshot when they did not change
+    const std::shared_ptr<const SnapshotTopology>& sharedTopology() const { return topology; }
+    const std::shared_ptr<const EdgeStateChunk>& sharedChunk(size_t index) const { return chunks[index]; }
+    const std::shared_ptr<const std::vector<std::uint8_t>>& sharedNodeOpen() const { return open; }
+
+    int nodeCount() const { return static_cast<int>(topology->nodeIds.size()); }
+    int edgeCount() const { return static_cast<int>(topology->to.size()); }
+
+    int indexOf(int id) const {
+        auto it = topology->nodeIndex.find(id);
+        return it != topology->nodeIndex.end() ? it->second : -1;
+    }
+    int idAt(int index) const { return topology->nodeIds[index]; }
+
+    int capacityOf(int e) const { return topology->capacity[e]; }
+    int currentLoadOf(int e) const { return chunkOf(e).currentLoad[e & (EdgeStateChunk::SIZE - 1)]; }
+    int loadLimit(int e) const { return chunkOf(e).limit[e & (EdgeStateChunk::SIZE - 1)]; }
+    bool canAddLoad(int e, int additionalLoad) const {
+        int limit = loadLimit(e);
+        return limit != INT_MIN && limit >= additionalLoad;
+    }
+
+    // False for offline locations and for locations without any route
+    bool isLocationOperational(int id) const {
+        int v = indexOf(id);
+        return v >= 0 && (*open)[v];
+    }
+
+    // Same contract (and same route) as TransportationNetwork::findOptimalPath at this version
+    bool findOptimalPath(int source, int destination, int requiredCapacity, std::vector<int>& path) const {
+        path.clear();
+        int src = indexOf(source);
+        int dst = indexOf(destination);
+        if (src < 0 || dst < 0) return false;
+
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        runDijkstra(*this, ws, src, dst, requiredCapacity);
+        if (!ws.reached(dst)) return false;
+        pathTo(ws, dst, path);
+        return true;
+    }
+
+    // Same contract as TransportationNetwork::findWidestPath at this version
+    int findWidestPath(int source, int destination, std::vector<int>& path) const {
+        path.clear();
+        int src = indexOf(source);
+        int dst = indexOf(destination);
+        if (src < 0 || dst < 0) return 0;
+
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        int width = runWidestPath(*this, ws, src, dst);
+        if (width <= 0) return 0;
+        pathTo(ws, dst, path);
+        return width;
+    }
+};
@@ -0,0 +1,172 @@
+// DSA concept used = Widest-path search (max-bottleneck Dijkstra) + Yen's k shortest loopless paths
+
+#pragma once
+#include "SearchWorkspace.h"
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+
+/*
+    Route queries that look at capacity instead of rejecting a load outright.
+    Both work on any CSR-shaped graph (rowStart / to / cost columns plus
+    loadLimit(edge) and canAddLoad(edge, load)) and on the caller's
+    SearchWorkspace, like runAStar.
+*/
+
+/*
+    Maximum-bottleneck search: finds the route from `source` to `destination`
+    whose tightest edge has the most spare capacity (loadLimit). The
+    workspace's distance of a node is minus the best bottleneck reaching it, so
+    the min-heap settles the widest node first. Returns the bottleneck of the
+    widest route, or 0 if the destination cannot be reached with any load.
+*/
+template <typename Graph>
+int runWidestPath(const Graph& g, SearchWorkspace& ws, int source, int destination) {
+    ws.prepare(g.nodeCount());
+    ws.setDistance(source, -INT_MAX, -1);
+    ws.heap.pushOrDecrease(source, -INT_MAX);
+
+    while (!ws.heap.empty()) {
+        int u = ws.heap.pop();
+        if (u == destination) break;
+
+        int widthU = -ws.distanceTo(u);
+        for (int e = g.rowStart[u]; e < g.rowStart[u + 1]; ++e) {
+            int limit = g.loadLimit(e);
+            if (limit <= 0) continue;
+            int v = g.to[e];
+            int candidate = -std::min(widthU, limit);
+            if (candidate < ws.distanceTo(v)) {
+                ws.setDistance(v, candidate, u, e);
+                ws.heap.pushOrDecrease(v, candidate);
+            }
+        }
+    }
+    return ws.reached(destination) && destination != source ? -ws.distanceTo(destination) : 0;
+}
+
+// One route found by yenKShortestPaths (dense node indices)
+struct CandidateRoute {
+    std::vector<int> nodes;      // source first
+    std::vector<int> edges;      // edges[i] leads from nodes[i] to nodes[i + 1]
+    long long cost = 0;
+    int bottleneck = 0;          // smallest loadLimit along the route
+};
+
+/*
+    Yen's algorithm. Writes up to `maxRoutes` loopless routes from source to
+    destination into `routes`, cheapest first, using only edges that can take
+    `requiredCapacity` more load (so every route returned can carry it).
+
+    Each further route deviates from an earlier one at some spur node: the
+    prefix up to the spur is kept, the edges that earlier routes with the same
+    prefix took out of the spur and the prefix's own nodes are banned, and one
+    Dijkstra from the spur finds the rest. Bans are generation-stamped arrays,
+    so they are lifted in O(1).
+*/
+template <typename Graph>
+void yenKShortestPaths(const Graph& g, SearchWorkspace& ws, int source, int destination,
+    int requiredCapacity, int maxRoutes, std::vector<CandidateRoute>& routes) {
+    routes.clear();
+    if (maxRoutes <= 0 || source == destination) return;
+
+    struct Scratch {
+        std::vector<std::uint32_t> bannedEdge;
+        std::vector<std::uint32_t> bannedNode;
+        std::uint32_t generation = 0;
+    };
+    thread_local Scratch scratch;
+    if (static_cast<int>(scratch.bannedEdge.size()) < g.edgeCount()) scratch.bannedEdge.resize(g.edgeCount(), 0);
+    if (static_cast<int>(scratch.bannedNode.size()) < g.nodeCount()) scratch.bannedNode.resize(g.nodeCount(), 0);
+
+    // The graph with the current bans applied
+    struct BannedView {
+        const Graph& g;
+        const Scratch& s;
+        const std::vector<int>& rowStart;
+        const std::vector<int>& to;
+        int nodeCount() const { return g.nodeCount(); }
+        bool canAddLoad(int e, int load) const {
+            return s.bannedEdge[e] != s.generation && s.bannedNode[g.to[e]] != s.generation && g.canAddLoad(e, load);
+        }
+    };
+    BannedView view{ g, scratch, g.rowStart, g.to };
+
+    auto nextGeneration = [&] {
+        if (++scratch.generation == 0) {
+            std::fill(scratch.bannedEdge.begin(), scratch.bannedEdge.end(), 0);
+            std::fill(scratch.bannedNode.begin(), scratch.bannedNode.end(), 0);
+            scratch.generation = 1;
+        }
+    };
+
+    auto finish = [&](CandidateRoute& r) {
+        r.cost = 0;
+        r.bottleneck = INT_MAX;
+        for (int e : r.edges) {
+            r.cost += g.cost[e];
+            r.bottleneck = std::min(r.bottleneck, g.loadLimit(e));
+        }
+    };
+
+    // Appends the route found by the last search from `from` to destination
+    auto appendSearchResult = [&](CandidateRoute& r, int from) {
+        size_t mark = r.edges.size();
+        for (int v = destination; v != from; v = ws.predecessor(v)) r.edges.push_back(ws.predecessorEdge(v));
+        std::reverse(r.edges.begin() + mark, r.edges.end());
+        for (size_t i = mark; i < r.edges.size(); ++i) r.nodes.push_back(g.to[r.edges[i]]);
+    };
+
+    nextGeneration();
+    runAStar(view, g.cost, ws, source, destination, requiredCapacity, [](int) { return 0; });
+    if (!ws.reached(destination)) return;
+    {
+        CandidateRoute first;
+        first.nodes.push_back(source);
+        appendSearchResult(first, source);
+        finish(first);
+        routes.push_back(std::move(first));
+    }
+
+    std::vector<CandidateRoute> candidates;
+    auto known = [&](const std::vector<int>& edges) {
+        for (const CandidateRoute& r : routes) if (r.edges == edges) return true;
+        for (const CandidateRoute& r : candidates) if (r.edges == edges) return true;
+        return false;
+    };
+
+    while (static_cast<int>(routes.size()) < maxRoutes) {
+        const CandidateRoute last = routes.back();
+        for (size_t i = 0; i + 1 < last.nodes.size(); ++i) {
+            int spur = last.nodes[i];
+            nextGeneration();
+            for (const CandidateRoute& r : routes) {
+                if (r.edges.size() > i && std::equal(last.edges.begin(), last.edges.begin() + i, r.edges.begin())) {
+                    scratch.bannedEdge[r.edges[i]] = scratch.generation;
+                }
+            }
+            for (size_t j = 0; j < i; ++j) scratch.bannedNode[last.nodes[j]] = scratch.generation;
+
+            runAStar(view, g.cost, ws, spur, destination, requiredCapacity, [](int) { return 0; });
+            if (!ws.reached(destination)) continue;
+
+            CandidateRoute candidate;
+            candidate.nodes.assign(last.nodes.begin(), last.nodes.begin() + i + 1);
+            candidate.edges.assign(last.edges.begin(), last.edges.begin() + i);
+            appendSearchResult(candidate, spur);
+            if (known(candidate.edges)) continue;
+            finish(candidate);
+            candidates.push_back(std::move(candidate));
+        }
+        if (candidates.empty()) break;
+
+        // Cheapest candidate next; fewer hops breaks ties
+        auto best = std::min_element(candidates.begin(), candidates.end(),
+            [](const CandidateRoute& a, const CandidateRoute& b) {
+                return a.cost != b.cost ? a.cost < b.cost : a.edges.size() < b.edges.size();
+            });
+        routes.push_back(std::move(*best));
+        candidates.erase(best);
+    }
+}
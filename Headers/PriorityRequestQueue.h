@@ -1,122 +1,293 @@
 #pragma once
 #include "Request.h"
+#include "Metrics.h"
 #include <vector>
 #include <unordered_map>
+#include <memory_resource>
 #include <iostream>
 #include <iomanip>
 #include <stdexcept>
+#include <iterator>
 
+/*
+    Max-heap of requests ordered by priority.
+
+    The heap itself only holds compact (priority, slot) keys. The Request
+    payloads live in a slab whose slots never move while the request is queued,
+    and `heapPos` maps each slot (the request's handle) to its heap index. A swap
+    during heapify therefore moves two small keys and writes two ints, instead of
+    moving whole Requests (with their strings) and rewriting a hash map.
+
+    Cancelled requests are tombstones: cancelRequest only marks them, and they are
+    dropped when they reach the top, so the top of the queue is always a live
+    request. Once tombstones make up most of the heap it is compacted and rebuilt
+    in O(N) with Floyd's heapify, the same way addRequests() bulk-loads a backlog.
+*/
 class PriorityRequestQueue {
 private:
-    std::vector<Request> heap;                          // Max-heap based on request priority
-    std::unordered_map<int, int> requestIndexMap;       // Maps requestId to index in heap
+    struct HeapKey {
+        int priority;
+        int slot;
+    };
+
+    std::vector<HeapKey> heap;                          // Max-heap based on request priority
+    std::vector<Request> slab;                          // Request payloads, indexed by handle
+    std::vector<int> heapPos;                           // handle -> index in heap, -1 if slot is free
+    std::vector<int> freeSlots;                         // handles ready for reuse
+    // requestId -> handle (touched only on add/remove). Its nodes come from a pool
+    // owned by the queue, so the add/remove churn of a day recycles the same
+    // chunks instead of going to the global heap for every request.
+    std::pmr::unsynchronized_pool_resource handleNodes;
+    std::pmr::unordered_map<int, int> handleById{ &handleNodes };
+    size_t cancelledCount = 0;                          // tombstones still in the heap
+
+    static constexpr size_t MIN_COMPACT_SIZE = 64;      // small heaps are never worth compacting
+
+    void setKey(int index, const HeapKey& key) {
+        heap[index] = key;
+        heapPos[key.slot] = index;
+    }
 
     // Maintain heap property after insertion or priority increase
     void heapifyUp(int index) {
+        HeapKey key = heap[index];
+        int swaps = 0;
         while (index > 0) {
             int parent = (index - 1) / 2;
-            if (heap[parent].priority >= heap[index].priority) break;
-
-            std::swap(heap[index], heap[parent]);
-            requestIndexMap[heap[index].requestId] = index;
-            requestIndexMap[heap[parent].requestId] = parent;
-
+            if (heap[parent].priority >= key.priority) break;
+            setKey(index, heap[parent]);
             index = parent;
+            ++swaps;
         }
+        setKey(index, key);
+        RRP_METRIC_ADD(QUEUE_SIFT_SWAPS, swaps);
     }
 
     // Maintain heap property after removal or priority decrease
     void heapifyDown(int index) {
         int size = static_cast<int>(heap.size());
+        HeapKey key = heap[index];
+        int swaps = 0;
         while (true) {
-            int largest = index;
+            int largest = -1;
+            int largestPriority = key.priority;
             int left = 2 * index + 1;
             int right = 2 * index + 2;
 
-            if (left < size && heap[left].priority > heap[largest].priority)
+            if (left < size && heap[left].priority > largestPriority) {
                 largest = left;
-            if (right < size && heap[right].priority > heap[largest].priority)
+                largestPriority = heap[left].priority;
+            }
+            if (right < size && heap[right].priority > largestPriority)
                 largest = right;
 
-            if (largest == index) break;
-
-            std::swap(heap[index], heap[largest]);
-            requestIndexMap[heap[index].requestId] = index;
-            requestIndexMap[heap[largest].requestId] = largest;
+            if (largest < 0) break;
 
+            setKey(index, heap[largest]);
             index = largest;
+            ++swaps;
         }
+        setKey(index, key);
+        RRP_METRIC_ADD(QUEUE_SIFT_SWAPS, swaps);
     }
 
-public:
-    // Insert a new request into the priority queue
-    void addRequest(const Request& req) {
-        heap.push_back(req);
-        int index = static_cast<int>(heap.size()) - 1;
-        requestIndexMap[req.requestId] = index;
+    int handleOf(int requestId) const {
+        auto it = handleById.find(requestId);
+        return it != handleById.end() ? it->second : -1;
+    }
+
+    // Takes the entry at heap index `index` out of the queue and frees its slot
+    void removeAt(int index) {
+        int slot = heap[index].slot;
+        handleById.erase(slab[slot].requestId);
+        heapPos[slot] = -1;
+        freeSlots.push_back(slot);
+
+        HeapKey last = heap.back();
+        heap.pop_back();
+        if (index == static_cast<int>(heap.size())) return;
+
+        setKey(index, last);
         heapifyUp(index);
+        heapifyDown(heapPos[last.slot]);
     }
 
-    // Get the highest-priority request without removing it
-    Request getTopRequest() const {
-        if (heap.empty()) throw std::runtime_error("Queue is empty");
-        return heap.front();
+    bool isCancelled(int slot) const {
+        return slab[slot].status == Request::Status::CANCELLED;
     }
 
-    // Process and remove the top-priority request
-    void processTopRequest() {
-        if (heap.empty()) throw std::runtime_error("Queue is empty");
+    // Stores the payload and appends its key at the end of the heap (not yet sifted)
+    int appendRequest(const Request& req) {
+        int slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            slab[slot] = req;
+        }
+        else {
+            slot = static_cast<int>(slab.size());
+            slab.push_back(req);
+            heapPos.push_back(-1);
+        }
+        handleById[req.requestId] = slot;
+        if (isCancelled(slot)) ++cancelledCount;
+
+        heap.push_back({ req.priority, slot });
+        heapPos[slot] = static_cast<int>(heap.size()) - 1;
+        RRP_METRIC_ADD(QUEUE_PUSHES, 1);
+        return slot;
+    }
+
+    // Floyd's bottom-up heap construction, O(N)
+    void rebuildHeap() {
+        for (int i = static_cast<int>(heap.size()) / 2 - 1; i >= 0; --i) heapifyDown(i);
+    }
 
-        requestIndexMap.erase(heap[0].requestId); // Remove mapping for top
+    // Physically removes every tombstone and rebuilds the heap
+    void compact() {
+        size_t kept = 0;
+        for (size_t i = 0; i < heap.size(); ++i) {
+            int slot = heap[i].slot;
+            if (isCancelled(slot)) {
+                handleById.erase(slab[slot].requestId);
+                heapPos[slot] = -1;
+                freeSlots.push_back(slot);
+            }
+            else {
+                setKey(static_cast<int>(kept++), heap[i]);
+            }
+        }
+        heap.resize(kept);
+        cancelledCount = 0;
+        rebuildHeap();
+    }
 
-        if (heap.size() == 1) {
-            heap.pop_back();
-            return;
+    // Restores "the top is live": drops tombstones from the top, compacts if they pile up
+    void purgeCancelled() {
+        if (heap.size() >= MIN_COMPACT_SIZE && cancelledCount * 2 > heap.size()) compact();
+        while (!heap.empty() && isCancelled(heap.front().slot)) {
+            removeAt(0);
+            --cancelledCount;
         }
+    }
 
-        heap[0] = heap.back();
-        requestIndexMap[heap[0].requestId] = 0;
-        heap.pop_back();
+public:
+    // Insert a new request into the priority queue; returns its handle
+    int addRequest(const Request& req) {
+        int slot = appendRequest(req);
+        heapifyUp(static_cast<int>(heap.size()) - 1);
+        purgeCancelled();
+        RRP_METRIC_RECORD(QUEUE_HEAP_DEPTH, metrics::heapDepth(heap.size()));
+        return slot;
+    }
+
+    /*
+        Inserts a whole range of requests. Large batches are appended unsorted and
+        the heap is rebuilt once with Floyd's method (O(N) instead of N log N sifts),
+        which is what replaying a big backlog needs.
+    */
+    template <typename InputIt>
+    void addRequests(InputIt first, InputIt last) {
+        size_t before = heap.size();
+        for (; first != last; ++first) appendRequest(*first);
+        size_t added = heap.size() - before;
+        if (added >= before) {
+            rebuildHeap();
+        }
+        else {
+            for (size_t i = before; i < heap.size(); ++i) heapifyUp(static_cast<int>(i));
+        }
+        purgeCancelled();
+        RRP_METRIC_RECORD(QUEUE_HEAP_DEPTH, metrics::heapDepth(heap.size()));
+    }
 
-        heapifyDown(0);
+    template <typename Range>
+    void addRequests(const Range& requests) {
+        addRequests(std::begin(requests), std::end(requests));
     }
 
-    // Update the priority of a specific request
-    void updateRequestPriority(int requestId, int newPriority) {
-        if (!requestIndexMap.count(requestId)) return;
+    // Pre-sizes the queue for `count` more requests (bulk loads of a known size)
+    void reserve(size_t count) {
+        heap.reserve(heap.size() + count);
+        slab.reserve(slab.size() + count);
+        heapPos.reserve(heapPos.size() + count);
+        handleById.reserve(handleById.size() + count);
+    }
 
-        int index = requestIndexMap[requestId];
+    // The highest-priority request, without removing it; valid until the queue is next changed
+    const Request& getTopRequest() const {
+        if (heap.empty()) throw std::runtime_error("Queue is empty");
+        return slab[heap.front().slot];
+    }
+
+    // Process and remove the top-priority request (cancelled ones are skipped automatically)
+    void processTopRequest() {
+        if (heap.empty()) throw std::runtime_error("Queue is empty");
+        removeAt(0);
+        purgeCancelled();
+        RRP_METRIC_ADD(QUEUE_POPS, 1);
+    }
+
+    // Update the priority of a specific request; false if it is not in the queue
+    bool updateRequestPriority(int requestId, int newPriority) {
+        int slot = handleOf(requestId);
+        if (slot < 0) return false;
+        return updatePriorityByHandle(slot, newPriority);
+    }
+
+    /*
+        Same as updateRequestPriority, for callers that kept the handle from addRequest.
+        False for a handle out of range or of a request that already left the queue.
+        Handles are reused once their request is gone, so drop them at that point.
+    */
+    bool updatePriorityByHandle(int handle, int newPriority) {
+        if (handle < 0 || handle >= static_cast<int>(heapPos.size()) || heapPos[handle] < 0) return false;
+        int index = heapPos[handle];
         int oldPriority = heap[index].priority;
         heap[index].priority = newPriority;
+        slab[handle].priority = newPriority;
+        RRP_METRIC_ADD(QUEUE_PRIORITY_UPDATES, 1);
 
         if (newPriority > oldPriority)
             heapifyUp(index);
         else if (newPriority < oldPriority)
             heapifyDown(index);
+        purgeCancelled();
+        return true;
     }
 
     // Access a specific request by its ID
     Request* getRequest(int requestId) {
-        if (!requestIndexMap.count(requestId)) return nullptr;
-        return &heap[requestIndexMap[requestId]];
+        int slot = handleOf(requestId);
+        return slot >= 0 ? &slab[slot] : nullptr;
     }
 
     // Update status (PENDING, COMPLETED, CANCELLED) of a request
     void updateRequestStatus(int requestId, Request::Status newStatus) {
-        if (!requestIndexMap.count(requestId)) return;
-        heap[requestIndexMap[requestId]].updateStatus(newStatus);
+        int slot = handleOf(requestId);
+        if (slot < 0) return;
+        bool wasCancelled = isCancelled(slot);
+        slab[slot].updateStatus(newStatus);
+        if (wasCancelled != isCancelled(slot)) {
+            if (wasCancelled) --cancelledCount;
+            else ++cancelledCount;
+            purgeCancelled();
+        }
     }
 
-    // Mark a request as cancelled
+    // Mark a request as cancelled; it stays in the heap as a tombstone until it surfaces
     void cancelRequest(int requestId) {
         updateRequestStatus(requestId, Request::Status::CANCELLED);
     }
 
-    // Check if the queue is empty
+    // Check if the queue is empty (tombstones do not count)
     bool isEmpty() const {
         return heap.empty();
     }
 
+    // Number of live (not cancelled) requests
+    size_t size() const { return heap.size() - cancelledCount; }
+
     // Display all requests in the queue
     void printAllRequests() const {
         std::cout << "\n========== All Pending Requests ==========\n";
@@ -132,16 +303,18 @@ public:
             << std::setw(20) << "Timestamp" << "\n";
         std::cout << std::string(100, '-') << "\n";
 
-        for (const auto& req : heap) {
+        for (const HeapKey& key : heap) {
+            if (isCancelled(key.slot)) continue;
+            const Request& req = slab[key.slot];
             std::cout << std::setw(5) << req.requestId
                 << std::setw(10) << req.priority
                 << std::setw(10) << Request::statusToString(req.status)
                 << std::setw(10) << Request::typeToString(req.type)
                 << std::setw(10) << req.sourceLocationId
                 << std::setw(10) << req.targetLocationId
-                << std::setw(15) << req.resourceType
+                << std::setw(15) << req.resourceType()
                 << std::setw(10) << req.requiredQuantity
-                << std::setw(20) << req.timestamp << "\n";
+                << std::setw(20) << formatTimestamp(req.timestamp) << "\n";
         }
     }
 };
@@ -1,13 +1,378 @@
 #pragma once
 #include "TransportationNetwork.h"
 #include "ResourceManager.h"
+#include "CriticalLevelTracker.h"
+#include "Utilities.h"
 #include <iostream>
+#include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
 
+enum class ReportFormat { TEXT, CSV, JSON };
+
+/*
+    Everything a report shows, copied out of the network and the resource
+    manager at one moment. Once taken it is immutable, so it can be formatted
+    and written on another thread while the simulation goes on.
+*/
+struct ReportSnapshot {
+    struct ResourceRow {
+        ResourceTypeId type;
+        int total, available, expiryDate, criticalLevel;
+        double unitCost, weight;
+        bool belowCritical;
+    };
+    struct LocationRow {
+        int id;
+        std::string name;
+        bool operational;
+        std::vector<std::pair<ResourceTypeId, int>> stock;   // types ever stocked here
+    };
+    struct AlertRow {
+        CriticalAlert alert;
+        std::string locationName;                            // empty for central stock
+    };
+    struct AllocationRow {
+        int source, target;
+        ResourceTypeId type;
+        int quantity;
+        Timestamp time;
+    };
+
+    int day = 0;                      // 0 = summary report
+    Timestamp takenAt = 0;
+    int operationalLocations = 0;     // of the locations connected to the central warehouse
+    int connectedLocations = 0;
+    std::vector<ResourceRow> resources;
+    std::vector<LocationRow> locations;                      // by location ID
+    std::vector<AlertRow> alerts;
+    std::vector<AllocationRow> newAllocations;               // appended since the previous report
+    size_t firstAllocation = 0;                              // ledger row of newAllocations[0]
+    size_t totalAllocations = 0;
+    AllocationLedger::TypeTotals allocatedByType{};          // over the whole history
+};
+
+// Formatting helpers shared by the report writers
+namespace report_format {
+
+    inline std::string csvField(const std::string& text) {
+        if (text.find_first_of(",\"\n") == std::string::npos) return text;
+        std::string quoted = "\"";
+        for (char c : text) {
+            if (c == '"') quoted += '"';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    inline std::string jsonString(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+                else out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    inline const char* extension(ReportFormat format) {
+        switch (format) {
+        case ReportFormat::CSV: return ".csv";
+        case ReportFormat::JSON: return ".json";
+        default: return ".txt";
+        }
+    }
+
+    inline void writeStatus(const ReportSnapshot& s, std::ostream& out) {
+        out << "\n========== DAY " << s.day << " STATUS REPORT ==========\n";
+        out << "\nNetwork Summary:\n";
+        out << "  Operational Locations: " << s.operationalLocations << "/" << s.connectedLocations << "\n";
+
+        out << "\n========== Critical Resources Alert ==========\n";
+        for (const ReportSnapshot::AlertRow& row : s.alerts) {
+            out << "WARNING: " << resourceTypeName(row.alert.type);
+            if (row.alert.locationId != CriticalLevelTracker::CENTRAL_STOCK) {
+                out << " at Loc" << row.alert.locationId << " (" << row.locationName << ")";
+            }
+            out << " is below critical level! Available: " << row.alert.available
+                << " (Critical threshold: " << row.alert.criticalLevel << ")\n";
+        }
+        if (s.alerts.empty()) out << "All resources are above critical levels.\n";
+    }
+
+    inline void writeUtilization(const ReportSnapshot& s, std::ostream& out) {
+        out << "\n========== RESOURCE UTILIZATION REPORT ==========\n";
+        for (const ReportSnapshot::LocationRow& loc : s.locations) {
+            out << "Location ID: " << loc.id << " (" << loc.name << ")\n";
+            out << "\n+----------------- Location Inventory ----------------+\n";
+            out << "| " << std::left << std::setw(20) << "Location ID: " << loc.id << " (" << loc.name << ")\n";
+            out << "+-----------------------+---------------------+\n";
+            out << "| " << std::setw(21) << "Resource Type" << " | " << std::setw(19) << "Quantity" << " |\n";
+            out << "+-----------------------+---------------------+\n";
+            for (const auto& item : loc.stock) {
+                out << "| " << std::setw(21) << resourceTypeName(item.first)
+                    << " | " << std::setw(19) << item.second << " |\n";
+            }
+            out << "+-----------------------+---------------------+\n";
+            out << "----------------------------------------\n";
+        }
+    }
+
+    inline void writeText(const ReportSnapshot& s, std::ostream& out) {
+        writeStatus(s, out);
+        writeUtilization(s, out);
+
+        out << "\n========== Central Resource Inventory ==========\n";
+        out << std::left << std::setw(15) << "Type" << std::setw(15) << "Total Qty" << std::setw(15) << "Available"
+            << std::setw(10) << "Expiry" << std::setw(10) << "Cost" << std::setw(10) << "Weight"
+            << std::setw(10) << "Critical" << "\n";
+        out << std::string(85, '-') << "\n";
+        for (const ReportSnapshot::ResourceRow& r : s.resources) {
+            out << std::setw(15) << resourceTypeName(r.type) << std::setw(15) << r.total << std::setw(15) << r.available
+                << std::setw(10) << (r.expiryDate > 0 ? std::to_string(r.expiryDate) + "d" : "N/A")
+                << std::setw(10) << r.unitCost << std::setw(10) << r.weight
+                << std::setw(10) << (r.belowCritical ? "YES" : "No") << "\n";
+        }
+
+        out << "\n========== Resource Allocations (new since last report: "
+            << s.newAllocations.size() << " of " << s.totalAllocations << ") ==========\n";
+        out << std::left << std::setw(15) << "Source" << std::setw(15) << "Target" << std::setw(15) << "Resource"
+            << std::setw(15) << "Quantity" << std::setw(20) << "Timestamp" << "\n";
+        out << std::string(80, '-') << "\n";
+        for (const ReportSnapshot::AllocationRow& a : s.newAllocations) {
+            out << std::setw(15) << a.source << std::setw(15) << a.target << std::setw(15) << resourceTypeName(a.type)
+                << std::setw(15) << a.quantity << std::setw(20) << formatTimestamp(a.time) << "\n";
+        }
+
+        out << "\nTotal allocated per resource (all time):\n";
+        for (const ReportSnapshot::ResourceRow& r : s.resources) {
+            out << "  " << std::setw(20) << resourceTypeName(r.type) << s.allocatedByType[r.type] << "\n";
+        }
+    }
+
+    /*
+        Long ("tidy") CSV: one value per row, so dashboards can pivot any
+        section without knowing the layout of the others.
+    */
+    inline void writeCsv(const ReportSnapshot& s, std::ostream& out) {
+        out << "day,section,location_id,location,resource,field,value\n";
+        auto row = [&](const char* section, const std::string& locationId, const std::string& location,
+            const std::string& resource, const char* field, const std::string& value) {
+            out << s.day << ',' << section << ',' << locationId << ',' << csvField(location) << ','
+                << csvField(resource) << ',' << field << ',' << value << '\n';
+        };
+        row("network", "", "", "", "operational_locations", std::to_string(s.operationalLocations));
+        row("network", "", "", "", "connected_locations", std::to_string(s.connectedLocations));
+        for (const ReportSnapshot::ResourceRow& r : s.resources) {
+            const std::string& name = resourceTypeName(r.type);
+            row("resource", "", "", name, "total", std::to_string(r.total));
+            row("resource", "", "", name, "available", std::to_string(r.available));
+            row("resource", "", "", name, "critical_level", std::to_string(r.criticalLevel));
+            row("resource", "", "", name, "below_critical", r.belowCritical ? "1" : "0");
+            row("resource", "", "", name, "allocated_total", std::to_string(s.allocatedByType[r.type]));
+        }
+        for (const ReportSnapshot::LocationRow& loc : s.locations) {
+            std::string id = std::to_string(loc.id);
+            row("location", id, loc.name, "", "operational", loc.operational ? "1" : "0");
+            for (const auto& item : loc.stock) {
+                row("location_stock", id, loc.name, resourceTypeName(item.first), "quantity", std::to_string(item.second));
+            }
+        }
+        for (const ReportSnapshot::AlertRow& a : s.alerts) {
+            std::string id = std::to_string(a.alert.locationId);
+            const std::string& name = resourceTypeName(a.alert.type);
+            row("alert", id, a.locationName, name, "available", std::to_string(a.alert.available));
+            row("alert", id, a.locationName, name, "critical_level", std::to_string(a.alert.criticalLevel));
+        }
+        row("allocations", "", "", "", "new_records", std::to_string(s.newAllocations.size()));
+        row("allocations", "", "", "", "total_records", std::to_string(s.totalAllocations));
+    }
+
+    inline void writeJson(const ReportSnapshot& s, std::ostream& out) {
+        out << "{\n  \"day\": " << s.day
+            << ",\n  \"generated_at\": " << jsonString(formatTimestamp(s.takenAt))
+            << ",\n  \"network\": {\"operational_locations\": " << s.operationalLocations
+            << ", \"connected_locations\": " << s.connectedLocations << "}";
+
+        out << ",\n  \"resources\": [";
+        for (size_t i = 0; i < s.resources.size(); ++i) {
+            const ReportSnapshot::ResourceRow& r = s.resources[i];
+            out << (i ? ",\n    " : "\n    ") << "{\"type\": " << jsonString(resourceTypeName(r.type))
+                << ", \"total\": " << r.total << ", \"available\": " << r.available
+                << ", \"expiry_days\": " << r.expiryDate << ", \"unit_cost\": " << r.unitCost
+                << ", \"weight\": " << r.weight << ", \"critical_level\": " << r.criticalLevel
+                << ", \"below_critical\": " << (r.belowCritical ? "true" : "false")
+                << ", \"allocated_total\": " << s.allocatedByType[r.type] << "}";
+        }
+        out << (s.resources.empty() ? "]" : "\n  ]");
+
+        out << ",\n  \"locations\": [";
+        for (size_t i = 0; i < s.locations.size(); ++i) {
+            const ReportSnapshot::LocationRow& loc = s.locations[i];
+            out << (i ? ",\n    " : "\n    ") << "{\"id\": " << loc.id << ", \"name\": " << jsonString(loc.name)
+                << ", \"operational\": " << (loc.operational ? "true" : "false") << ", \"stock\": {";
+            for (size_t k = 0; k < loc.stock.size(); ++k) {
+                out << (k ? ", " : "") << jsonString(resourceTypeName(loc.stock[k].first)) << ": " << loc.stock[k].second;
+            }
+            out << "}}";
+        }
+        out << (s.locations.empty() ? "]" : "\n  ]");
+
+        out << ",\n  \"alerts\": [";
+        for (size_t i = 0; i < s.alerts.size(); ++i) {
+            const ReportSnapshot::AlertRow& a = s.alerts[i];
+            out << (i ? ",\n    " : "\n    ") << "{\"location_id\": " << a.alert.locationId
+                << ", \"resource\": " << jsonString(resourceTypeName(a.alert.type))
+                << ", \"available\": " << a.alert.available << ", \"critical_level\": " << a.alert.criticalLevel << "}";
+        }
+        out << (s.alerts.empty() ? "]" : "\n  ]");
+
+        out << ",\n  \"allocations\": {\"first_record\": " << s.firstAllocation
+            << ", \"new_records\": " << s.newAllocations.size()
+            << ", \"total_records\": " << s.totalAllocations << "}\n}\n";
+    }
+
+    inline void write(const ReportSnapshot& s, ReportFormat format, std::ostream& out) {
+        switch (format) {
+        case ReportFormat::CSV: writeCsv(s, out); break;
+        case ReportFormat::JSON: writeJson(s, out); break;
+        default: writeText(s, out); break;
+        }
+    }
+
+    // One allocation per line: CSV rows, or JSON Lines objects
+    inline void writeAllocations(const ReportSnapshot& s, ReportFormat format, bool withHeader, std::ostream& out) {
+        if (format == ReportFormat::JSON) {
+            for (const ReportSnapshot::AllocationRow& a : s.newAllocations) {
+                out << "{\"source\": " << a.source << ", \"target\": " << a.target
+                    << ", \"resource\": " << jsonString(resourceTypeName(a.type))
+                    << ", \"quantity\": " << a.quantity << ", \"time\": " << jsonString(formatTimestamp(a.time)) << "}\n";
+            }
+            return;
+        }
+        if (withHeader) out << "source,target,resource,quantity,timestamp\n";
+        for (const ReportSnapshot::AllocationRow& a : s.newAllocations) {
+            out << a.source << ',' << a.target << ',' << csvField(resourceTypeName(a.type)) << ','
+                << a.quantity << ',' << formatTimestamp(a.time) << '\n';
+        }
+    }
+}
+
+/*
+    Builds status and utilization reports.
+
+    Reports are written from a ReportSnapshot into an explicit output sink
+    (any std::ostream or a file), never by redirecting std::cout. Each
+    snapshot carries only the allocations recorded since the previous one,
+    so a report costs O(resources + locations + new allocations) no matter how
+    long the simulation has been running.
+
+    With startBackgroundWriter(), submitReport() only takes the snapshot on
+    the caller's thread; formatting and file I/O happen on a writer thread.
+    Each report is formatted into memory and written with a single write.
+    An optional allocation log receives every allocation exactly once,
+    appended as the reports go out.
+*/
 class ReportGenerator {
+public:
+    struct WriterStats {
+        std::uint64_t written;
+        std::uint64_t failed;      // files that could not be opened or written
+        size_t pending;
+    };
+
+private:
+    struct Job {
+        std::shared_ptr<const ReportSnapshot> snapshot;
+        std::string filename;
+        ReportFormat format;
+    };
+
     TransportationNetwork& network;      // Reference to the transportation network for status queries
     ResourceManager& resourceManager;    // Reference to the resource manager for resource data and critical level checks
+    size_t allocationCursor = 0;         // ledger rows already handed to a report
+
+    // Allocation log (written by whoever writes the reports)
+    std::string allocationLogFile;
+    ReportFormat allocationLogFormat = ReportFormat::CSV;
+    std::ofstream allocationLog;
+
+    // Background writer
+    std::thread writer;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<Job> queue;
+    bool writing = false;                // the writer holds a job outside the queue
+    bool stopping = false;
+    std::uint64_t writtenCount = 0;
+    std::uint64_t failedCount = 0;
+
+    bool writeFile(const Job& job) {
+        std::ostringstream text;
+        report_format::write(*job.snapshot, job.format, text);
+        std::ofstream file(job.filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        const std::string& bytes = text.str();
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(file);
+    }
+
+    void appendAllocations(const ReportSnapshot& s) {
+        if (allocationLogFile.empty() || s.newAllocations.empty()) return;
+        if (!allocationLog.is_open()) {
+            allocationLog.open(allocationLogFile, std::ios::binary | std::ios::trunc);
+            if (!allocationLog.is_open()) return;
+            report_format::writeAllocations(ReportSnapshot(), allocationLogFormat, true, allocationLog);
+        }
+        std::ostringstream text;
+        report_format::writeAllocations(s, allocationLogFormat, false, text);
+        const std::string& bytes = text.str();
+        allocationLog.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        allocationLog.flush();
+    }
+
+    void process(const Job& job) {
+        bool ok = writeFile(job);
+        appendAllocations(*job.snapshot);
+        std::lock_guard<std::mutex> lock(queueMutex);
+        ++(ok ? writtenCount : failedCount);
+    }
+
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        while (true) {
+            queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;   // stopping and drained
+            Job job = std::move(queue.front());
+            queue.pop_front();
+            writing = true;
+            lock.unlock();
+            process(job);
+            lock.lock();
+            writing = false;
+            queueChanged.notify_all();
+        }
+    }
 
 public:
     // Constructor initializes references to network and resource manager
@@ -15,89 +380,163 @@ public:
         : network(net), resourceManager(rm) {
     }
 
-    /**
-     * @brief Generates and prints a daily status report summarizing network and resource status.
-     * @param day The day number to identify the report.
-     */
-    void generateDailyStatusReport(int day) {
-        std::cout << "\n========== DAY " << day << " STATUS REPORT ==========\n";
-
-        // Network status summary: count operational locations connected to central warehouse (ID = 1)
-        std::cout << "\nNetwork Summary:\n";
-        int operationalLocations = 0;
-        int totalLocations = 0;
-
-        // Get all edges from central warehouse (location 1)
-        auto edgesFromCentral = network.getEdges(1);
-        for (const auto& edge : edgesFromCentral) {
-            Location* loc = network.getLocation(edge.to);
-            if (loc) {
-                totalLocations++;
-                if (loc->isOperational) {
-                    operationalLocations++;
+    ~ReportGenerator() { stopBackgroundWriter(); }
+
+    ReportGenerator(const ReportGenerator&) = delete;
+    ReportGenerator& operator=(const ReportGenerator&) = delete;
+
+    /*
+        Copies the current state into a snapshot. With `consumeAllocations`
+        the snapshot takes the allocations recorded since the previous
+        consuming snapshot and moves the cursor past them.
+    */
+    std::shared_ptr<ReportSnapshot> takeSnapshot(int day, bool consumeAllocations = true) {
+        std::shared_ptr<ReportSnapshot> s = std::make_shared<ReportSnapshot>();
+        s->day = day;
+        s->takenAt = nowTimestamp();
+
+        // Network status summary: locations connected to the central warehouse (ID = 1)
+        for (const auto& edge : network.getEdges(1)) {
+            const Location* loc = network.getLocation(edge.to);
+            if (!loc) continue;
+            ++s->connectedLocations;
+            if (loc->isOperational) ++s->operationalLocations;
+        }
+
+        for (const Resource& res : resourceManager.getResources()) {
+            s->resources.push_back({ res.typeId, res.totalQuantity(), res.getAvailableQuantity(), res.expiryDate,
+                res.criticalLevel, res.unitCost, res.weight, res.isBelowCriticalLevel() });
+        }
+
+        for (const auto& entry : network.getLocations()) {
+            const Location& loc = entry.second;
+            ReportSnapshot::LocationRow row{ loc.id, loc.name, loc.isOperational, {} };
+            std::uint64_t stocked = loc.stockedTypes.load(std::memory_order_acquire);
+            for (int type = 0; type < MAX_RESOURCE_TYPES; ++type) {
+                if (stocked >> type & 1) {
+                    row.stock.emplace_back(static_cast<ResourceTypeId>(type), loc.getAvailableQuantity(static_cast<ResourceTypeId>(type)));
                 }
             }
+            s->locations.push_back(std::move(row));
         }
+        std::sort(s->locations.begin(), s->locations.end(),
+            [](const ReportSnapshot::LocationRow& a, const ReportSnapshot::LocationRow& b) { return a.id < b.id; });
 
-        // Report on operational vs total locations
-        std::cout << "  Operational Locations: " << operationalLocations << "/" << totalLocations << "\n";
+        for (const CriticalAlert& alert : resourceManager.criticalLevels().currentAlerts()) {
+            const Location* loc = alert.locationId == CriticalLevelTracker::CENTRAL_STOCK ? nullptr
+                : network.getLocation(alert.locationId);
+            s->alerts.push_back({ alert, loc ? loc->name : std::string() });
+        }
 
-        // Check resource critical levels and print warnings or alerts as needed
-        resourceManager.checkCriticalLevels();
+        const AllocationLedger& ledger = resourceManager.allocations();
+        s->totalAllocations = ledger.size();
+        s->allocatedByType = ledger.totalsByType();
+        if (consumeAllocations) {
+            s->firstAllocation = allocationCursor;
+            s->newAllocations.reserve(ledger.size() - allocationCursor);
+            ledger.forEachFrom(allocationCursor, [&](int source, int target, ResourceTypeId type, int qty, Timestamp time) {
+                s->newAllocations.push_back({ source, target, type, qty, time });
+            });
+            allocationCursor = ledger.size();
+        }
+        else {
+            s->firstAllocation = ledger.size();
+        }
+        return s;
     }
 
     /**
-     * @brief Prints resource utilization details for a given set of locations.
-     *
-     * Assumes location IDs are from 1 to N; currently hardcoded for 3 locations.
-     * Consider extending this method to dynamically get all locations from the network.
+     * @brief Generates and prints a daily status report summarizing network and resource status.
+     * @param day The day number to identify the report.
      */
-    void generateResourceUtilizationReport() {
-        std::cout << "\n========== RESOURCE UTILIZATION REPORT ==========\n";
-
-        // Define which locations to report on; here fixed as 1,2,3 for simplicity
-        constexpr int minLocationId = 2;
-        constexpr int maxLocationId = 5;
-
-        for (int locationId = minLocationId; locationId <= maxLocationId; ++locationId) {
-            Location* loc = network.getLocation(locationId);
-            if (loc) {
-                std::cout << "Location ID: " << locationId << " (" << loc->name << ")\n";
-                loc->printInventory();
-                std::cout << "----------------------------------------\n";
-            }
-            else {
-                // Report missing or invalid location info
-                std::cout << "Location ID: " << locationId << " - No data available.\n";
-            }
-        }
+    void generateDailyStatusReport(int day, std::ostream& out = std::cout) {
+        report_format::writeStatus(*takeSnapshot(day, false), out);
+    }
+
+    // Prints every location's inventory
+    void generateResourceUtilizationReport(std::ostream& out = std::cout) {
+        report_format::writeUtilization(*takeSnapshot(0, false), out);
+    }
+
+    // Writes a full report (with the allocations since the last report) to `out`, on this thread
+    void writeReport(int day, ReportFormat format, std::ostream& out) {
+        waitForReports();   // keeps the allocation log in order
+        std::shared_ptr<ReportSnapshot> s = takeSnapshot(day);
+        report_format::write(*s, format, out);
+        appendAllocations(*s);
+    }
+
+    /*
+        Appends every allocation, once, to `filename` (CSV rows, or JSON Lines
+        for ReportFormat::JSON) whenever a report is written. Set it before
+        the first report and before startBackgroundWriter().
+    */
+    void setAllocationLog(const std::string& filename, ReportFormat format = ReportFormat::CSV) {
+        allocationLogFile = filename;
+        allocationLogFormat = format;
     }
 
     /**
-     * @brief Saves combined reports (daily status, resource utilization, and resource manager inventory/allocations)
-     *        into a specified file.
+     * @brief Saves a full report (status, utilization, inventory, new allocations) into a file.
+     *        Blocks until the file is written; see submitReport for the background version.
      * @param filename Name of the file where the report should be saved.
      */
-    void saveReportToFile(const std::string& filename) {
-        std::ofstream file(filename);
-        if (!file.is_open()) {
+    bool saveReportToFile(const std::string& filename, ReportFormat format = ReportFormat::TEXT, int day = 0) {
+        std::uint64_t failedBefore = writerStats().failed;
+        submitReport(filename, format, day);
+        waitForReports();
+        if (writerStats().failed != failedBefore) {
             std::cerr << "Error: Could not open file '" << filename << "' for writing.\n";
-            return;
+            return false;
         }
+        std::cout << "Report successfully saved to '" << filename << "'.\n";
+        return true;
+    }
+
+    // Starts the writer thread used by submitReport (no-op if it is running)
+    void startBackgroundWriter() {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (writer.joinable()) return;
+        stopping = false;
+        writer = std::thread([this] { writerLoop(); });
+    }
 
-        // Redirect std::cout output to the file stream temporarily
-        std::streambuf* originalCoutBuffer = std::cout.rdbuf();
-        std::cout.rdbuf(file.rdbuf());
+    // Writes out everything still queued and stops the writer thread
+    void stopBackgroundWriter() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (!writer.joinable()) return;
+            stopping = true;
+        }
+        queueChanged.notify_all();
+        writer.join();
+    }
 
-        // Generate reports into the file
-        generateDailyStatusReport(0);        // Day 0 or summary report
-        generateResourceUtilizationReport();
-        resourceManager.printInventory();
-        resourceManager.printAllocations();
+    /*
+        Takes a snapshot now and has the writer thread format and save it.
+        Without a running writer the report is written before returning.
+    */
+    void submitReport(const std::string& filename, ReportFormat format = ReportFormat::TEXT, int day = 0) {
+        Job job{ takeSnapshot(day), filename, format };
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (writer.joinable()) {
+                queue.push_back(std::move(job));
+                queueChanged.notify_all();
+                return;
+            }
+        }
+        process(job);
+    }
 
-        // Restore std::cout output back to the console
-        std::cout.rdbuf(originalCoutBuffer);
+    // Blocks until every submitted report is on disk
+    void waitForReports() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueChanged.wait(lock, [this] { return queue.empty() && !writing; });
+    }
 
-        std::cout << "Report successfully saved to '" << filename << "'.\n";
+    WriterStats writerStats() {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return { writtenCount, failedCount, queue.size() + (writing ? 1 : 0) };
     }
 };
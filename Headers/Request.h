@@ -1,6 +1,9 @@
 #pragma once
 #include "Utilities.h"
+#include "ResourceTypeRegistry.h"
 #include <string>
+#include <string_view>
+#include <memory_resource>
 
 /*
     The Request class models a resource-related request in a disaster management system.
@@ -21,8 +24,8 @@ public:
     int sourceLocationId;
     int targetLocationId;
 
-    // Type of resource requested (e.g., "Water", "Medicine")
-    std::string resourceType;
+    // Type of resource requested (interned id of e.g. "Water", "Medicine")
+    ResourceTypeId resourceTypeId;
 
     // Amount of the resource that is needed
     int requiredQuantity;
@@ -39,21 +42,44 @@ public:
     // Type of request (supply, demand, transfer)
     Type type;
 
-    // When the request was created
-    std::string timestamp;
+    // When the request was created (formatted only when printed, see formatTimestamp)
+    Timestamp timestamp;
 
-    // Optional human-readable notes for logging/traceability
-    std::string notes;
+    // Optional human-readable notes for logging/traceability. They come from the
+    // memory resource the request was built with (the heap unless a caller passes
+    // one, e.g. the simulation's per-day arena); copies use the heap again, and
+    // assigning keeps the target's resource.
+    std::pmr::string notes;
 
     /*
         Constructor to initialize all the major fields.
         By default, a request is assumed to be a DEMAND and its status is PENDING.
     */
-    Request(int id, int sourceId, int targetId, const std::string& type, int qty, int prio,
-        Type reqType = Type::DEMAND, const std::string& time = getCurrentTimestamp())
+    Request(int id, int sourceId, int targetId, ResourceTypeId resourceType, int qty, int prio,
+        Type reqType = Type::DEMAND, Timestamp time = nowTimestamp())
         : requestId(id), sourceLocationId(sourceId), targetLocationId(targetId),
-        resourceType(type), requiredQuantity(qty), fulfilledQuantity(0),
-        priority(prio), status(Status::PENDING), type(reqType), timestamp(time), notes("") {
+        resourceTypeId(resourceType), requiredQuantity(qty), fulfilledQuantity(0),
+        priority(prio), status(Status::PENDING), type(reqType), timestamp(time) {
+    }
+
+    // Copy whose notes (now and when added later) are allocated from `notesMemory`
+    Request(const Request& other, std::pmr::memory_resource* notesMemory)
+        : requestId(other.requestId), sourceLocationId(other.sourceLocationId),
+        targetLocationId(other.targetLocationId), resourceTypeId(other.resourceTypeId),
+        requiredQuantity(other.requiredQuantity), fulfilledQuantity(other.fulfilledQuantity),
+        priority(other.priority), status(other.status), type(other.type), timestamp(other.timestamp),
+        notes(other.notes, notesMemory) {
+    }
+
+    // Same, naming the resource type (interned on the way in)
+    Request(int id, int sourceId, int targetId, const std::string& resourceType, int qty, int prio,
+        Type reqType = Type::DEMAND, Timestamp time = nowTimestamp())
+        : Request(id, sourceId, targetId, internResourceType(resourceType), qty, prio, reqType, time) {
+    }
+
+    // Name of the requested resource type (for display/logging)
+    const std::string& resourceType() const {
+        return resourceTypeName(resourceTypeId);
     }
 
     // Update the priority level of a request
@@ -85,7 +111,7 @@ public:
     }
 
     // Append additional information to the request's notes
-    void addNotes(const std::string& newNotes) {
+    void addNotes(std::string_view newNotes) {
         if (!notes.empty()) notes += "; ";
         notes += newNotes;
     }
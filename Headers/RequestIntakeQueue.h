@@ -0,0 +1,144 @@
+// DSA concept used = Lock-free multi-producer / single-consumer linked queue
+
+#pragma once
+#include "Request.h"
+#include "PriorityRequestQueue.h"
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/*
+    Intake buffer in front of PriorityRequestQueue.
+
+    Any number of gateway threads call submit() concurrently; a submit is one
+    atomic exchange plus one store, so producers never take a lock or wait for
+    each other or for the scheduler. The simulation thread is the only consumer:
+    at the start of each processing cycle it calls drainInto(), which moves
+    everything submitted so far into the priority queue with a single bulk insert.
+
+    (Vyukov's intrusive MPSC queue: producers swap themselves in at `head`, the
+    consumer follows `next` pointers from `tail`, which always points at a stub.)
+*/
+class RequestIntakeQueue {
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        std::optional<Request> request;
+        std::int64_t enqueuedAtNs = 0;
+    };
+
+    alignas(64) std::atomic<Node*> head;       // producers' end
+    alignas(64) Node* tail;                    // consumer's end (the current stub)
+
+    // Producer-side counters
+    alignas(64) std::atomic<std::uint64_t> submittedCount{ 0 };
+    std::atomic<std::int64_t> backlog{ 0 };
+
+    // Consumer-side counters (only touched by the draining thread)
+    std::uint64_t drainedCount = 0;
+    std::int64_t maxBacklogSeen = 0;
+    std::int64_t totalLatencyNs = 0;
+    std::int64_t maxLatencyNs = 0;
+    std::vector<Request> drainBuffer;          // reused between drains
+
+    static std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Moves one request onto `out`; false if the queue is empty (or a push is half done)
+    bool tryPop(std::vector<Request>& out, std::int64_t& enqueuedAtNs) {
+        Node* stub = tail;
+        Node* next = stub->next.load(std::memory_order_acquire);
+        if (next == nullptr) return false;
+        tail = next;
+        out.push_back(std::move(*next->request));
+        next->request.reset();
+        enqueuedAtNs = next->enqueuedAtNs;
+        delete stub;
+        return true;
+    }
+
+public:
+    struct Stats {
+        std::uint64_t submitted;     // total requests submitted by producers
+        std::uint64_t drained;       // total requests moved into the priority queue
+        std::int64_t backlog;        // submitted but not drained yet
+        std::int64_t maxBacklog;     // largest backlog seen at a drain
+        double averageLatencyUs;     // submit -> drain, averaged over drained requests
+        double maxLatencyUs;
+    };
+
+    RequestIntakeQueue() {
+        Node* stub = new Node();
+        head.store(stub, std::memory_order_relaxed);
+        tail = stub;
+    }
+
+    ~RequestIntakeQueue() {
+        Node* node = tail;
+        while (node) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    RequestIntakeQueue(const RequestIntakeQueue&) = delete;
+    RequestIntakeQueue& operator=(const RequestIntakeQueue&) = delete;
+
+    // Thread-safe, lock-free: called by any number of producer threads
+    void submit(const Request& req) {
+        Node* node = new Node();
+        node->request.emplace(req);
+        node->enqueuedAtNs = nowNs();
+        backlog.fetch_add(1, std::memory_order_relaxed);
+        submittedCount.fetch_add(1, std::memory_order_relaxed);
+
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /*
+        Consumer only: moves up to `maxCount` submitted requests into `queue` with
+        one bulk insert and returns how many were moved. Requests still being
+        pushed at this moment are picked up by the next drain.
+    */
+    size_t drainInto(PriorityRequestQueue& queue, size_t maxCount = SIZE_MAX) {
+        std::int64_t depth = backlog.load(std::memory_order_relaxed);
+        maxBacklogSeen = std::max(maxBacklogSeen, depth);
+
+        drainBuffer.clear();
+        std::int64_t enqueuedAt = 0;
+        while (drainBuffer.size() < maxCount && tryPop(drainBuffer, enqueuedAt)) {
+            std::int64_t latency = nowNs() - enqueuedAt;
+            totalLatencyNs += latency;
+            maxLatencyNs = std::max(maxLatencyNs, latency);
+        }
+
+        size_t count = drainBuffer.size();
+        if (count > 0) {
+            queue.addRequests(drainBuffer);
+            backlog.fetch_sub(static_cast<std::int64_t>(count), std::memory_order_relaxed);
+            drainedCount += count;
+        }
+        return count;
+    }
+
+    // Approximate number of requests waiting (safe to call from any thread)
+    std::int64_t backlogDepth() const { return backlog.load(std::memory_order_relaxed); }
+
+    // Consumer only
+    Stats stats() const {
+        Stats s;
+        s.submitted = submittedCount.load(std::memory_order_relaxed);
+        s.drained = drainedCount;
+        s.backlog = backlog.load(std::memory_order_relaxed);
+        s.maxBacklog = maxBacklogSeen;
+        s.averageLatencyUs = drainedCount ? totalLatencyNs / 1000.0 / drainedCount : 0.0;
+        s.maxLatencyUs = maxLatencyNs / 1000.0;
+        return s;
+    }
+};
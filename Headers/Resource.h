@@ -1,16 +1,56 @@
 #pragma once
+#include "ResourceTypeRegistry.h"
+#include "CriticalLevelWatcher.h"
 #include <string>
-#include <algorithm> 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 
 // The Resource class represents a type of resource (e.g., Water, Food, Medicine)
 // with its properties like total quantity, cost, expiry, etc.
 // It supports operations like allocation, release, consumption, and stock management.
+// The stock counters are one packed 64-bit atomic (total in the high half, allocated
+// in the low half), so every operation is a single CAS loop: several scheduler threads
+// can allocate from the same resource without a lock and never see a total and an
+// allocated count that do not belong together.
+// A watched resource reports every change that moves its available stock across
+// the critical level to its CriticalLevelWatcher (see CriticalLevelTracker).
 
 class Resource {
+    friend class CriticalLevelTracker;
+
+    std::atomic<std::uint64_t> quantities;
+    CriticalLevelWatcher* watcher = nullptr;   // set by CriticalLevelTracker::watch
+    int alertSlot = -1;                        // position in the tracker's alert list, -1 if not listed
+
+    static std::uint64_t pack(int total, int allocated) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(total)) << 32) |
+            static_cast<std::uint32_t>(allocated);
+    }
+    static int totalOf(std::uint64_t q) { return static_cast<int>(static_cast<std::uint32_t>(q >> 32)); }
+    static int allocatedOf(std::uint64_t q) { return static_cast<int>(static_cast<std::uint32_t>(q)); }
+
+    // Applies `change(total, allocated)` atomically; it returns false to leave the counters alone
+    template <typename Change>
+    bool update(Change change) {
+        std::uint64_t current = quantities.load(std::memory_order_relaxed);
+        while (true) {
+            int total = totalOf(current);
+            int allocated = allocatedOf(current);
+            int before = total - allocated;
+            if (!change(total, allocated)) return false;
+            if (quantities.compare_exchange_weak(current, pack(total, allocated),
+                std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                int after = total - allocated;
+                if (watcher && (before < criticalLevel) != (after < criticalLevel)) watcher->resourceChanged(*this);
+                return true;
+            }
+        }
+    }
+
 public:
     std::string type;        // Type of resource (e.g., "Water", "Medicine")
-    int totalQuantity;       // Total units of this resource in stock
-    int allocatedQuantity;   // Units that are currently allocated/reserved
+    ResourceTypeId typeId;   // Interned id of `type`
     int expiryDate;          // Optional: expiry date (e.g., YYYYMMDD format)
     double unitCost;         // Cost per unit (useful for optimization or budgeting)
     double weight;           // Weight per unit (used in transport logistics)
@@ -19,41 +59,81 @@ public:
     // Constructor 
     Resource(const std::string& type, int qty, int expiry = 0, double cost = 1.0,
         double weight = 1.0, int criticalLevel = 100)
-        : type(type),
-        totalQuantity(qty),
-        allocatedQuantity(0),
+        : quantities(pack(qty, 0)),
+        type(type),
+        typeId(internResourceType(type)),
         expiryDate(expiry),
         unitCost(cost),
         weight(weight),
         criticalLevel(criticalLevel) {
     }
 
+    // Copies take a snapshot of the counters; the copy is not watched
+    Resource(const Resource& other)
+        : quantities(other.quantities.load(std::memory_order_acquire)),
+        type(other.type), typeId(other.typeId), expiryDate(other.expiryDate),
+        unitCost(other.unitCost), weight(other.weight), criticalLevel(other.criticalLevel) {
+    }
+
+    Resource& operator=(const Resource& other) {
+        quantities.store(other.quantities.load(std::memory_order_acquire), std::memory_order_release);
+        type = other.type;
+        typeId = other.typeId;
+        expiryDate = other.expiryDate;
+        unitCost = other.unitCost;
+        weight = other.weight;
+        criticalLevel = other.criticalLevel;
+        if (watcher) watcher->resourceChanged(*this);
+        return *this;
+    }
+
+    // Changes the threshold; a watcher re-checks the resource right away
+    void setCriticalLevel(int level) {
+        criticalLevel = level;
+        if (watcher) watcher->resourceChanged(*this);
+    }
+
+    // Total units of this resource in stock
+    int totalQuantity() const { return totalOf(quantities.load(std::memory_order_acquire)); }
+
+    // Units that are currently allocated/reserved
+    int allocatedQuantity() const { return allocatedOf(quantities.load(std::memory_order_acquire)); }
+
     // Tries to allocate 'qty' units of the resource
     // Returns true if successful (enough stock available), false otherwise
     bool allocate(int qty) {
-        if (getAvailableQuantity() >= qty) {
-            allocatedQuantity += qty;
+        return update([qty](int& total, int& allocated) {
+            if (total - allocated < qty) return false;
+            allocated += qty;
             return true;
-        }
-        return false;
+        });
     }
 
     // Releases 'qty' units that were previously allocated
     // Ensures that allocated quantity never goes below zero
     void release(int qty) {
-        allocatedQuantity = std::max(0, allocatedQuantity - qty);
+        update([qty](int&, int& allocated) {
+            allocated = std::max(0, allocated - qty);
+            return true;
+        });
     }
 
     // Consumes 'qty' units of the resource (e.g., used or wasted)
     // Affects both allocated and total stock
     void consume(int qty) {
-        allocatedQuantity = std::max(0, allocatedQuantity - qty);
-        totalQuantity = std::max(0, totalQuantity - qty);
+        update([qty](int& total, int& allocated) {
+            allocated = std::max(0, allocated - qty);
+            total = std::max(0, total - qty);
+            return true;
+        });
     }
 
     // Adds 'qty' new units to the stock (e.g., received from suppliers)
     void addStock(int qty) {
-        totalQuantity += qty;
+        update([qty](int& total, int&) {
+            total += qty;
+            return true;
+        });
     }
 
     // Checks if the available (unallocated) quantity has fallen below the critical level
@@ -63,6 +143,7 @@ public:
 
     // Returns the number of units that are available (not allocated)
     int getAvailableQuantity() const {
-        return totalQuantity - allocatedQuantity;
+        std::uint64_t q = quantities.load(std::memory_order_acquire);
+        return totalOf(q) - allocatedOf(q);
     }
 };
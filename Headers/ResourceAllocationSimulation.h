@@ -6,37 +6,142 @@
 #include "EventLogger.h"
 #include "DisasterSimulator.h"
 #include "ReportGenerator.h"
+#include "BatchRequestRouter.h"
+#include "RequestIntakeQueue.h"
+#include "NetworkImage.h"
+#include "CsvImporter.h"
+#include "DayArena.h"
 
 #include <random>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstdio>
+
+/*
+    Settings of one run. Everything random in a run (initial route loads,
+    disasters, daily requests) is drawn from generators seeded from `seed`, so
+    two runs with the same seed make exactly the same decisions. Nothing is
+    shared between simulations, so independent runs can go on separate threads
+    as long as they use different log files and leave writeReports off.
+*/
+struct SimulationConfig {
+    std::uint64_t seed = 0;                     // 0 = pick a random seed (see ResourceAllocationSimulation::seed())
+    std::string logFile = "simulation.log";     // empty = no log file
+    bool consoleOutput = true;                  // false = print nothing (status, reports, log echo)
+    bool writeReports = true;                   // day_N_report.txt and final_simulation_report.txt
+    int scale = 1;                              // multiplies daily request volume and initial stock
+    int requestsPerDay = 0;                     // 0 = 1-3 new requests a day (times scale), else exactly this many
+    ReportFormat reportFormat = ReportFormat::TEXT;   // format of the report files
+    std::string networkImage;                   // empty = built-in demo network, else load this NetworkImage file
+    std::string requestsCsv;                    // non-empty = also queue the requests of this CSV export on day 1
+    std::string metricsFile;                    // non-empty = dump the metrics registry here after the run
+                                                // (JSON for *.json, else Prometheus text; see Metrics.h)
+    bool shipmentsInTransit = false;            // true = allocations travel and hold their route until they
+                                                // arrive (see ShipmentScheduler), false = delivered at once
+    ShipmentSchedulerOptions shipmentOptions;   // time resolution and speed when shipmentsInTransit is set
+};
+
+// Outcome counters of one run
+struct SimulationStats {
+    int days = 0;
+    int requestsHandled = 0;            // requests taken off the queue
+    int fulfilled = 0;
+    int partiallyFulfilled = 0;
+    int rejectedOffline = 0;            // an endpoint was not operational
+    int rejectedNoRoute = 0;
+    int rejectedNoStock = 0;
+    int shippedFromLocalStock = 0;      // fulfilled from a nearby site's stock instead of the warehouse
+    long long unitsRequested = 0;
+    long long unitsDelivered = 0;       // with shipments in transit: units that arrived
+    int shipmentsDelivered = 0;         // only with shipments in transit
+    int shipmentsInTransit = 0;         // ... still on their way when the run ended
+    int criticalResourceDays = 0;       // resource types below critical level, summed over days
+    DisruptionStats disruptions;
+
+    double fulfillmentRate() const {
+        return requestsHandled > 0 ? static_cast<double>(fulfilled) / requestsHandled : 0.0;
+    }
+    double deliveryRate() const {
+        return unitsRequested > 0 ? static_cast<double>(unitsDelivered) / unitsRequested : 0.0;
+    }
+};
+
+/*
+    Derives the seed of an independent random stream from a base seed
+    (SplitMix64 finalizer), so nearby seeds still give unrelated streams.
+*/
+inline std::uint64_t mixSeed(std::uint64_t seed, std::uint64_t stream) {
+    std::uint64_t z = seed + 0x9E3779B97F4A7C15ull * (stream + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
 
 class ResourceAllocationSimulation {
+    // Holds the central stock; default source of generated requests
+    static constexpr int CENTRAL_WAREHOUSE = 1;
+
+    SimulationConfig config;
+    std::ostream discard{ nullptr };    // swallows output when console output is off
+    std::ostream& console;
+
     TransportationNetwork network;
     ResourceManager resourceManager;
     PriorityRequestQueue requestQueue;
+    RequestIntakeQueue requestIntake;   // requests submitted from other threads
     EventLogger logger;
     DisasterSimulator disasterSim;
     ReportGenerator reportGen;
+    ShipmentScheduler shipments;        // used when config.shipmentsInTransit is set
 
     int simulationDay;
     int nextRequestId;
     std::mt19937 rng;
+    SimulationStats runStats;
+    std::vector<int> routeBuffer;   // reused by processRequests for every route query
+    std::vector<SpatialNeighbor> supplierBuffer;   // candidate sources of the current request
+    std::vector<int> requestTargets;    // locations daily requests are sent to (all but the warehouse)
+    DayArena dayArena;                  // notes of the requests processed today; reset at the end of each day
+    std::unique_ptr<BatchRequestRouter> batchRouter;   // null = serial request processing
 
 public:
-    ResourceAllocationSimulation()
-        : resourceManager(network),
-        logger("simulation.log"),
-        disasterSim(network, logger),
+    explicit ResourceAllocationSimulation(const SimulationConfig& cfg = SimulationConfig())
+        : config(withSeed(cfg)),
+        console(cfg.consoleOutput ? std::cout : discard),
+        resourceManager(network),
+        logger(cfg.logFile),
+        disasterSim(network, logger, static_cast<std::uint32_t>(mixSeed(config.seed, 1)), console),
         reportGen(network, resourceManager),
+        shipments(network, config.shipmentOptions),
         simulationDay(1),
         nextRequestId(1),
-        rng(std::random_device{}()) // Initialize RNG once here
+        rng(static_cast<std::uint32_t>(mixSeed(config.seed, 0))) // Initialize RNG once here
     {
-        initializeSystem();
+        logger.setConsoleEcho(config.consoleOutput);
+        // Report files are formatted and written off the simulation thread
+        if (config.writeReports) reportGen.startBackgroundWriter();
+        network.seedRandom(static_cast<std::uint32_t>(mixSeed(config.seed, 2)));
+        shipments.onArrival([this](const Shipment& s) {
+            ++runStats.shipmentsDelivered;
+            runStats.unitsDelivered += s.quantity;
+            logger.logShipmentArrival(s.sourceLocationId, s.targetLocationId, s.type, s.quantity);
+        });
+        if (config.networkImage.empty()) initializeSystem();
+        else loadNetworkImage(config.networkImage);
+        if (!config.requestsCsv.empty()) importRequests(config.requestsCsv);
     }
 
+    // Seed of this run; pass it in SimulationConfig::seed to repeat the run
+    std::uint64_t seed() const { return config.seed; }
+
+    const SimulationStats& stats() const { return runStats; }
+
     void initializeSystem() {
         // Initialize locations with clear info and consistent parameters
         network.addLocation(Location(1, "Central Warehouse", 34.0522, -118.2437, true, 10000));
@@ -55,26 +160,36 @@ public:
         network.addEdge(3, 5, 600, 10, true, 9.3, "road");   // Shelter to South Hub
         network.addEdge(4, 5, 700, 9, true, 5.8, "road");    // East Medical to South Hub
 
-        // Initialize resources with detailed characteristics
-        resourceManager.addResource(Resource("Medical Kits", 1000, 365, 50.0, 2.5, 200));
-        resourceManager.addResource(Resource("Water", 5000, 90, 2.0, 1.0, 1000));
-        resourceManager.addResource(Resource("Emergency Food", 3000, 180, 8.0, 0.75, 500));
-        resourceManager.addResource(Resource("Blankets", 800, 0, 15.0, 1.5, 100));
-        resourceManager.addResource(Resource("Medicines", 500, 240, 100.0, 0.5, 100));
+        // Initialize resources with detailed characteristics (stock and thresholds grow with the scale)
+        const int k = std::max(1, config.scale);
+        resourceManager.addResource(Resource("Medical Kits", 1000 * k, 365, 50.0, 2.5, 200 * k));
+        resourceManager.addResource(Resource("Water", 5000 * k, 90, 2.0, 1.0, 1000 * k));
+        resourceManager.addResource(Resource("Emergency Food", 3000 * k, 180, 8.0, 0.75, 500 * k));
+        resourceManager.addResource(Resource("Blankets", 800 * k, 0, 15.0, 1.5, 100 * k));
+        resourceManager.addResource(Resource("Medicines", 500 * k, 240, 100.0, 0.5, 100 * k));
 
         // Seed initial inventory at locations safely
         if (auto* hospital = network.getLocation(2)) {
-            hospital->addResource("Medical Kits", 200);
-            hospital->addResource("Water", 500);
-            hospital->addResource("Medicines", 100);
+            hospital->addResource("Medical Kits", 200 * k);
+            hospital->addResource("Water", 500 * k);
+            hospital->addResource("Medicines", 100 * k);
         }
 
         if (auto* shelter = network.getLocation(3)) {
-            shelter->addResource("Water", 300);
-            shelter->addResource("Emergency Food", 400);
-            shelter->addResource("Blankets", 200);
+            shelter->addResource("Water", 300 * k);
+            shelter->addResource("Emergency Food", 400 * k);
+            shelter->addResource("Blankets", 200 * k);
         }
 
+        // Local stock the field sites should not drop below
+        resourceManager.setLocationCriticalLevel(2, internResourceType("Medical Kits"), 50 * k);
+        resourceManager.setLocationCriticalLevel(2, internResourceType("Medicines"), 25 * k);
+        resourceManager.setLocationCriticalLevel(3, internResourceType("Water"), 100 * k);
+        resourceManager.setLocationCriticalLevel(3, internResourceType("Emergency Food"), 100 * k);
+
+        logCriticalTransitions();
+        requestTargets = { 2, 3, 4, 5 };
+
         // Seed initial requests with clear logging
         requestQueue.addRequest(Request(nextRequestId++, 1, 2, "Medical Kits", 200, 10));
         requestQueue.addRequest(Request(nextRequestId++, 1, 3, "Emergency Food", 500, 8));
@@ -83,140 +198,383 @@ public:
         logger.log("System initialized with 5 locations, 8 routes, 5 resource types, and 3 initial requests");
     }
 
+    /*
+        Starts from a network and inventory saved with saveNetworkImage instead
+        of the built-in demo network. Throws if the file is not a valid image.
+    */
+    void loadNetworkImage(const std::string& filename) {
+        NetworkImage image;
+        if (!image.open(filename) || !image.restore(network, resourceManager)) {
+            throw std::runtime_error("Cannot load network image '" + filename + "'");
+        }
+        logCriticalTransitions();
+        requestTargets.clear();
+        for (const auto& entry : network.getLocations()) {
+            if (entry.first != CENTRAL_WAREHOUSE) requestTargets.push_back(entry.first);
+        }
+        std::sort(requestTargets.begin(), requestTargets.end());
+        logger.log("System loaded from " + filename + ": " + std::to_string(image.locationCount()) +
+            " locations, " + std::to_string(image.edgeCount() / 2) + " routes, " +
+            std::to_string(image.resourceCount()) + " resource types");
+    }
+
+    /*
+        Queues every request of a CSV export (see CsvImporter::importRequests).
+        Rows without an id are numbered after the existing requests. Malformed
+        rows are skipped and logged; throws if the file cannot be read.
+    */
+    CsvImportStats importRequests(const std::string& filename) {
+        CsvImporter importer(network);
+        CsvImportStats result = importer.importRequests(filename, requestQueue, nextRequestId);
+        logger.log("Imported " + std::to_string(result.imported) + " requests from " + filename +
+            " (" + std::to_string(result.skipped) + " rows skipped)");
+        for (const std::string& error : result.errors) logger.log("  " + filename + " " + error);
+        return result;
+    }
+
+    // Writes the current network and inventory as a NetworkImage; false if the file cannot be written
+    bool saveNetworkImage(const std::string& filename) const {
+        return NetworkImage::write(filename, network, resourceManager);
+    }
+
+    /*
+        Entry point for gateway threads: submit requests here from any thread.
+        They are merged into the priority queue at the start of the next day.
+    */
+    RequestIntakeQueue& intake() { return requestIntake; }
+
+    /*
+        Routes requests in batches of `batchSize` on `threadCount` workers (0 = one per core)
+        instead of one at a time. Allocation results are the same as the serial loop.
+        Pass batchSize 0 to go back to serial processing.
+    */
+    void enableBatchRouting(size_t threadCount, size_t batchSize) {
+        if (batchSize == 0) batchRouter.reset();
+        else batchRouter.reset(new BatchRequestRouter(threadCount, batchSize));
+    }
+
+    /*
+        Moves event logging to a background writer thread (see EventLogger::startAsync).
+        `consoleEcho` false keeps log lines out of the console output.
+    */
+    void enableAsyncLogging(const EventLogger::AsyncOptions& options = EventLogger::AsyncOptions(),
+        bool consoleEcho = true) {
+        logger.setConsoleEcho(consoleEcho);
+        logger.startAsync(options);
+    }
+
+    /*
+        Records typed events, including every route load change, to a binary
+        journal (see EventJournal.h) that replayJournal() can apply to a freshly
+        initialized system. With keepTextLog false those events are no longer
+        written as text.
+    */
+    bool enableJournal(const std::string& filename, bool keepTextLog = true) {
+        if (!logger.openJournal(filename)) return false;
+        logger.setTextLog(keepTextLog);
+        network.recordLoadChanges(&logger.eventJournal());
+        return true;
+    }
+
     void runSimulation(int totalDays) {
-        std::cout << "\n========== Starting Resource Allocation Simulation ==========\n";
+        console << "\n========== Starting Resource Allocation Simulation ==========\n";
 
         for (; simulationDay <= totalDays; ++simulationDay) {
-            std::cout << "\n========== DAY " << simulationDay << " ==========\n";
+            console << "\n========== DAY " << simulationDay << " ==========\n";
             logger.log("Beginning of Day " + std::to_string(simulationDay));
 
             processRequests();
-            resourceManager.checkCriticalLevels();
+            dayArena.reset();   // today's requests are done with
+            if (config.shipmentsInTransit) moveShipments();
+            runStats.criticalResourceDays += resourceManager.countBelowCriticalLevel();
 
             // 20% chance of disaster event, run only if disasterSim enabled
             if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < 0.2) {
                 disasterSim.runRandomEvent(resourceManager);
             }
 
-            reportGen.generateDailyStatusReport(simulationDay);
+            // The status report includes the critical-level check
+            if (config.consoleOutput) reportGen.generateDailyStatusReport(simulationDay);
 
             if (simulationDay < totalDays) {
                 generateDailyRequests();
             }
 
-            if (simulationDay % 5 == 0) {
-                reportGen.saveReportToFile("day_" + std::to_string(simulationDay) + "_report.txt");
+            if (config.writeReports && simulationDay % 5 == 0) {
+                reportGen.submitReport("day_" + std::to_string(simulationDay) + "_report" +
+                    report_format::extension(config.reportFormat), config.reportFormat, simulationDay);
             }
+            ++runStats.days;
         }
 
+        runStats.disruptions = disasterSim.stats();
+        runStats.shipmentsInTransit = static_cast<int>(shipments.inTransit());
         printFinalReport();
+        if (!config.metricsFile.empty() && !writeMetrics(config.metricsFile)) {
+            logger.log("Could not write metrics to " + config.metricsFile);
+        }
+    }
+
+    /*
+        Writes the hot-path metrics (routing, queue, allocation, logging) collected
+        so far in this process; JSON for a *.json file, else Prometheus text.
+        All zeros unless the build defines RRP_METRICS.
+    */
+    bool writeMetrics(const std::string& filename) const {
+        return metrics::writeSnapshot(filename, metrics::MetricsRegistry::instance().snapshot());
     }
 
 private:
+    // Copy of `cfg` with a zero seed replaced by a random one
+    static SimulationConfig withSeed(SimulationConfig cfg) {
+        if (cfg.seed == 0) {
+            std::random_device rd;
+            cfg.seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+            if (cfg.seed == 0) cfg.seed = 1;
+        }
+        return cfg;
+    }
+
+    // Log every crossing of a critical level as it happens
+    void logCriticalTransitions() {
+        resourceManager.criticalLevels().onTransition([this](const CriticalAlert& alert, bool below) {
+            std::string where = alert.locationId == CriticalLevelTracker::CENTRAL_STOCK
+                ? std::string("central stock") : "Loc" + std::to_string(alert.locationId);
+            logger.log("Critical level " + std::string(below ? "reached" : "recovered") + ": " +
+                resourceTypeName(alert.type) + " at " + where + " (" + std::to_string(alert.available) +
+                "/" + std::to_string(alert.criticalLevel) + ")");
+        });
+    }
+
+    /*
+        With shipments in transit the day's requests are dispatched spread evenly
+        over the day, so routes freed by earlier arrivals can be used again:
+        runs the shipments up to the tick the `index`-th of `count` requests leaves.
+    */
+    void waitForDispatch(size_t index, size_t count) {
+        if (!config.shipmentsInTransit || count == 0) return;
+        SimTick dayStart = static_cast<SimTick>(simulationDay - 1) * shipments.ticksPerDay();
+        SimTick offset = static_cast<SimTick>(index * static_cast<size_t>(shipments.ticksPerDay()) / count);
+        shipments.advanceTo(dayStart + offset - 1);
+    }
+
+    // Runs the rest of the day: shipments pass their routes, give the load back edge by edge and arrive
+    void moveShipments() {
+        SimTick endOfDay = static_cast<SimTick>(simulationDay) * shipments.ticksPerDay() - 1;
+        size_t delivered = shipments.advanceTo(endOfDay);
+        logger.log("Delivered " + std::to_string(delivered) + " shipments, " +
+            std::to_string(shipments.inTransit()) + " still in transit");
+    }
+
     void processRequests() {
         int processedCount = 0;
 
+        // Pick up everything field gateways submitted since the last cycle
+        size_t intakeCount = requestIntake.drainInto(requestQueue);
+        if (intakeCount > 0) {
+            logger.log("Accepted " + std::to_string(intakeCount) + " requests from intake");
+        }
+
         if (requestQueue.isEmpty()) {
-            std::cout << "No requests to process today.\n";
+            console << "No requests to process today.\n";
             return;
         }
 
-        requestQueue.printAllRequests();
-
-        while (!requestQueue.isEmpty()) {
-            Request current = requestQueue.getTopRequest();
-
-            std::cout << "\nProcessing Request #" << current.requestId
-                << " (" << current.resourceType << " x" << current.requiredQuantity
-                << " from Loc" << current.sourceLocationId << " to Loc" << current.targetLocationId << ")\n";
-
-            logger.logRequest(current);
-
-            if (!network.isLocationOperational(current.sourceLocationId) ||
-                !network.isLocationOperational(current.targetLocationId)) {
-                current.updateStatus(Request::Status::INVALID);
-                current.addNotes("One or both locations are not operational");
-                std::cout << "Request invalid: One or both locations are not operational!\n";
+        if (config.consoleOutput) requestQueue.printAllRequests();
+        size_t dayRequests = requestQueue.size();
+        size_t dispatched = 0;
+
+        if (batchRouter) {
+            // Route a batch of top requests in parallel, then commit them in priority order
+            while (!requestQueue.isEmpty()) {
+                size_t count = batchRouter->routeNextBatch(requestQueue, network);
+                for (size_t i = 0; i < count; ++i) {
+                    RoutedRequest& routed = batchRouter->at(i);
+                    waitForDispatch(dispatched++, dayRequests);
+                    bool current = BatchRequestRouter::routeIsCurrent(routed, network);
+                    if (handleRequest(routed.request, current ? &routed.path : nullptr)) ++processedCount;
+                }
+            }
+        }
+        else {
+            while (!requestQueue.isEmpty()) {
+                // Taken off the queue before it is handled; its notes live in today's arena
+                Request current(requestQueue.getTopRequest(), dayArena.resource());
                 requestQueue.processTopRequest();
-                continue;
+                waitForDispatch(dispatched++, dayRequests);
+                if (handleRequest(current, nullptr)) ++processedCount;
             }
+        }
 
-            auto path = network.findOptimalPath(
-                current.sourceLocationId, current.targetLocationId, current.requiredQuantity);
+        console << "\nProcessed " << processedCount << " requests.\n";
+    }
 
-            if (path.empty()) {
-                current.updateStatus(Request::Status::INVALID);
-                current.addNotes("No valid transportation route available");
-                std::cout << "No valid transportation route available!\n";
-                requestQueue.processTopRequest();
-                continue;
-            }
+    /*
+        Validates, routes and allocates one request that was already taken off the queue.
+        `precomputedPath` is a route found earlier on the current network (batch mode);
+        when null the route is looked up here. Returns false if the request was
+        rejected before an allocation was attempted.
+    */
+    bool handleRequest(Request& current, const std::vector<int>* precomputedPath) {
+        console << "\nProcessing Request #" << current.requestId
+            << " (" << current.resourceType() << " x" << current.requiredQuantity
+            << " from Loc" << current.sourceLocationId << " to Loc" << current.targetLocationId << ")\n";
+
+        logger.logRequest(current);
+        ++runStats.requestsHandled;
+        runStats.unitsRequested += current.requiredQuantity;
+
+        // Stock already held at a site nearer than the source is shipped from there instead
+        if (network.isLocationOperational(current.targetLocationId) && shipFromNearestStock(current)) return true;
+
+        if (!network.isLocationOperational(current.sourceLocationId) ||
+            !network.isLocationOperational(current.targetLocationId)) {
+            current.updateStatus(Request::Status::INVALID);
+            current.addNotes("One or both locations are not operational");
+            ++runStats.rejectedOffline;
+            console << "Request invalid: One or both locations are not operational!\n";
+            return false;
+        }
 
-            std::cout << "Optimal route found: ";
-            for (size_t i = 0; i < path.size(); ++i) {
-                std::cout << path[i];
-                if (i < path.size() - 1) std::cout << " -> ";
+        const std::vector<int>& path = precomputedPath ? *precomputedPath : routeBuffer;
+        if (!precomputedPath) {
+            network.findCachedPath(
+                current.sourceLocationId, current.targetLocationId, current.requiredQuantity, routeBuffer);
+        }
+
+        if (path.empty()) {
+            current.updateStatus(Request::Status::INVALID);
+            current.addNotes("No valid transportation route available");
+            ++runStats.rejectedNoRoute;
+            // Tell the planner how much a single route could still carry, so it can split the shipment
+            int widest = network.findWidestPath(current.sourceLocationId, current.targetLocationId, routeBuffer);
+            if (widest > 0) {
+                char note[64];
+                int length = std::snprintf(note, sizeof note, "Largest load on one route: %d", widest);
+                current.addNotes(std::string_view(note, static_cast<size_t>(length)));
             }
-            std::cout << "\n";
+            console << "No valid transportation route available!\n";
+            return false;
+        }
 
-            bool resourceAvailable = resourceManager.hasAvailableResource(
-                current.resourceType, current.requiredQuantity);
+        console << "Optimal route found: ";
+        for (size_t i = 0; i < path.size(); ++i) {
+            console << path[i];
+            if (i < path.size() - 1) console << " -> ";
+        }
+        console << "\n";
 
-            if (!resourceAvailable) {
-                current.updateStatus(Request::Status::INVALID);
-                current.addNotes("Insufficient resources available");
-                std::cout << "Insufficient resources available!\n";
-                requestQueue.processTopRequest();
-                continue;
-            }
+        bool resourceAvailable = resourceManager.hasAvailableResource(
+            current.resourceTypeId, current.requiredQuantity);
+
+        if (!resourceAvailable) {
+            current.updateStatus(Request::Status::INVALID);
+            current.addNotes("Insufficient resources available");
+            ++runStats.rejectedNoStock;
+            console << "Insufficient resources available!\n";
+            return false;
+        }
 
-            bool allocationSuccess = resourceManager.allocateResources(
-                current.resourceType, current.requiredQuantity,
+        bool allocationSuccess = config.shipmentsInTransit
+            ? resourceManager.dispatchAllocation(current.resourceTypeId, current.requiredQuantity,
+                current.sourceLocationId, current.targetLocationId, shipments)
+            : resourceManager.allocateResources(current.resourceTypeId, current.requiredQuantity,
                 current.sourceLocationId, current.targetLocationId);
 
-            if (allocationSuccess) {
-                current.updateStatus(Request::Status::FULFILLED);
-                current.fulfillPartial(current.requiredQuantity);
-                std::cout << "Successfully allocated resources!\n";
-                logger.logAllocation(
-                    current.sourceLocationId, current.targetLocationId,
-                    current.resourceType, current.requiredQuantity, current.timestamp);
-            }
-            else {
-                current.updateStatus(Request::Status::PARTIALLY_FULFILLED);
-                std::cout << "Partial allocation: transportation constraints!\n";
-            }
+        if (allocationSuccess) {
+            current.updateStatus(Request::Status::FULFILLED);
+            current.fulfillPartial(current.requiredQuantity);
+            ++runStats.fulfilled;
+            if (!config.shipmentsInTransit) runStats.unitsDelivered += current.requiredQuantity;
+            console << "Successfully allocated resources!\n";
+            logger.logAllocation(
+                current.sourceLocationId, current.targetLocationId,
+                current.resourceTypeId, current.requiredQuantity, current.timestamp,
+                config.shipmentsInTransit ? AllocationKind::CENTRAL_SHIPMENT : AllocationKind::CENTRAL);
+        }
+        else {
+            current.updateStatus(Request::Status::PARTIALLY_FULFILLED);
+            ++runStats.partiallyFulfilled;
+            console << "Partial allocation: transportation constraints!\n";
+        }
+        return true;
+    }
 
-            requestQueue.processTopRequest();
-            ++processedCount;
+    /*
+        Source selection: looks up the operational sites nearest to the target that
+        hold enough of the resource above their own critical level (spatial index),
+        and ships from the first one with a route that can carry the quantity. Only sites
+        closer than the request's source are considered, unless that source is
+        offline or the central stock is short. Returns false if none could ship.
+    */
+    bool shipFromNearestStock(Request& current) {
+        const Location* target = network.getLocation(current.targetLocationId);
+        const Location* source = network.getLocation(current.sourceLocationId);
+        if (!target) return false;
+
+        double sourceKm = std::numeric_limits<double>::infinity();
+        if (source && source->isOperational &&
+            resourceManager.hasAvailableResource(current.resourceTypeId, current.requiredQuantity)) {
+            sourceKm = greatCircleDistanceKm(*source, *target);
         }
 
-        std::cout << "\nProcessed " << processedCount << " requests.\n";
+        resourceManager.findNearestSuppliers(current.targetLocationId, current.resourceTypeId,
+            current.requiredQuantity, 3, supplierBuffer);
+        for (const SpatialNeighbor& supplier : supplierBuffer) {
+            if (supplier.distanceKm >= sourceKm) break;
+            // Point-to-point: a cached shortest-path tree per ad-hoc supplier would evict the warehouse trees
+            if (!network.findOptimalPath(supplier.id, current.targetLocationId, current.requiredQuantity, routeBuffer)) continue;
+            bool shipped = config.shipmentsInTransit
+                ? resourceManager.dispatchRelocation(supplier.id, current.targetLocationId,
+                    current.resourceTypeId, current.requiredQuantity, shipments)
+                : resourceManager.relocateStock(supplier.id, current.targetLocationId,
+                    current.resourceTypeId, current.requiredQuantity);
+            if (!shipped) continue;
+
+            current.sourceLocationId = supplier.id;
+            current.updateStatus(Request::Status::FULFILLED);
+            current.fulfillPartial(current.requiredQuantity);
+            ++runStats.fulfilled;
+            ++runStats.shippedFromLocalStock;
+            if (!config.shipmentsInTransit) runStats.unitsDelivered += current.requiredQuantity;
+            console << "Shipped from local stock at Loc" << supplier.id
+                << " (" << supplier.distanceKm << " km away)\n";
+            logger.logAllocation(
+                current.sourceLocationId, current.targetLocationId,
+                current.resourceTypeId, current.requiredQuantity, current.timestamp,
+                config.shipmentsInTransit ? AllocationKind::RELOCATION_SHIPMENT : AllocationKind::RELOCATION);
+            return true;
+        }
+        return false;
     }
 
     void generateDailyRequests() {
-        std::uniform_int_distribution<int> countDist(1, 3);
-        int newRequestCount = countDist(rng);
-
-        std::vector<std::string> resourceTypes = {
-            "Medical Kits", "Water", "Emergency Food", "Blankets", "Medicines"
+        std::uniform_int_distribution<int> countDist(1 * std::max(1, config.scale), 3 * std::max(1, config.scale));
+        int newRequestCount = config.requestsPerDay > 0 ? config.requestsPerDay : countDist(rng);
+        if (requestTargets.empty()) return;
+
+        // Interned once; requests only carry the id
+        static const std::vector<ResourceTypeId> resourceTypes = {
+            internResourceType("Medical Kits"), internResourceType("Water"),
+            internResourceType("Emergency Food"), internResourceType("Blankets"),
+            internResourceType("Medicines")
         };
         std::uniform_int_distribution<size_t> typeDist(0, resourceTypes.size() - 1);
-        std::uniform_int_distribution<int> locDist(2, 5);
+        std::uniform_int_distribution<int> locDist(0, static_cast<int>(requestTargets.size()) - 1);
         std::uniform_int_distribution<int> qtyDist(50, 500);
         std::uniform_int_distribution<int> prioDist(3, 10);
 
         for (int i = 0; i < newRequestCount; ++i) {
-            std::string resType = resourceTypes[typeDist(rng)];
-            int targetLoc = locDist(rng);
+            ResourceTypeId resType = resourceTypes[typeDist(rng)];
+            int targetLoc = requestTargets[locDist(rng)];
             int qty = qtyDist(rng);
             int priority = prioDist(rng);
 
-            Request newReq(nextRequestId++, 1, targetLoc, resType, qty, priority);
+            Request newReq(nextRequestId++, CENTRAL_WAREHOUSE, targetLoc, resType, qty, priority);
             requestQueue.addRequest(newReq);
 
-            std::cout << "New request generated: #" << newReq.requestId
-                << " for " << resType << " x" << qty
+            console << "New request generated: #" << newReq.requestId
+                << " for " << resourceTypeName(resType) << " x" << qty
                 << " to location " << targetLoc
                 << " (Priority: " << priority << ")\n";
 
@@ -225,14 +583,23 @@ private:
     }
 
     void printFinalReport() {
-        std::cout << "\n========== FINAL SIMULATION REPORT ==========\n";
+        if (config.consoleOutput) {
+            std::cout << "\n========== FINAL SIMULATION REPORT ==========\n";
 
-        network.printNetworkStatus();
-        resourceManager.printInventory();
-        reportGen.generateResourceUtilizationReport();
-        resourceManager.printAllocations();
-        reportGen.saveReportToFile("final_simulation_report.txt");
+            network.printNetworkStatus();
+            resourceManager.printInventory();
+            reportGen.generateResourceUtilizationReport();
+            resourceManager.printAllocations();
+        }
+        if (config.writeReports) {
+            std::string filename = std::string("final_simulation_report") + report_format::extension(config.reportFormat);
+            reportGen.submitReport(filename, config.reportFormat);
+            reportGen.waitForReports();
+            ReportGenerator::WriterStats written = reportGen.writerStats();
+            if (written.failed == 0) console << "Report successfully saved to '" << filename << "'.\n";
+            else std::cerr << "Error: " << written.failed << " report file(s) could not be written.\n";
+        }
 
-        std::cout << "\n========== Simulation Completed ==========\n";
+        console << "\n========== Simulation Completed ==========\n";
     }
 };
@@ -4,26 +4,92 @@
 #include "TransportationNetwork.h"
 #include "Utilities.h"
 #include "Request.h"
+#include "AllocationLedger.h"
+#include "MultiCommodityFlowPlanner.h"
+#include "CriticalLevelTracker.h"
+#include "ShipmentScheduler.h"
+#include "Metrics.h"
 #include <vector>
-#include <tuple>
+#include <array>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+
+/*
+    A transfer whose route load and source stock are held but not yet
+    delivered (see ResourceManager::reserveTransfer). Commit delivers it,
+    rollback gives both back; either is O(path length).
+*/
+struct TransferReservation {
+    int sourceLocationId = -1;
+    int targetLocationId = -1;
+    ResourceTypeId type = INVALID_RESOURCE_TYPE;
+    int quantity = 0;
+    RouteReservation route;      // edge handles and the load put on them
+    bool held = false;
+};
 
 class ResourceManager {
-    std::unordered_map<std::string, Resource> resources;
-    std::vector<std::tuple<int, int, std::string, int, std::string>> allocationRecords; // source, target, type, qty, timestamp
+    std::vector<Resource> resources;                    // in the order they were added
+    CriticalLevelTracker criticalTracker;               // stocks below their critical level (after `resources`: detaches them first)
+    std::array<std::atomic<int>, MAX_RESOURCE_TYPES> resourceIndex;  // type id -> index in resources, -1 if none
+    std::mutex registrationMutex;       // serializes addResource (the only change to `resources`)
+    std::mutex ledgerMutex;             // allocation records are appended by any allocating thread
+    AllocationLedger allocationRecords;                 // source, target, type, qty, timestamp
     TransportationNetwork& network;
     int nextRequestId = 1;
+    TransferReservation transferBuffer;   // reused by transferResources so it does not allocate
+
+    MultiCommodityFlowPlanner flowPlanner;
 
+    void recordAllocation(int source, int target, ResourceTypeId type, int qty) {
+        Timestamp now = nowTimestamp();
+        std::lock_guard<std::mutex> lock(ledgerMutex);
+        allocationRecords.append(source, target, type, qty, now);
+    }
+
+    // True if every route along `path` (location IDs) can take `load` more
+    bool routeCanCarry(const std::vector<int>& path, int load) const {
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            int from = path[i];
+            int to = path[i + 1];
+            bool edgeFound = false;
+            for (const auto& edge : network.getEdges(from)) {
+                if (edge.to == to && edge.canAddLoad(load)) {
+                    edgeFound = true;
+                    break;
+                }
+            }
+            if (!edgeFound) return false;
+        }
+        return true;
+    }
 
 public:
-    ResourceManager(TransportationNetwork& net) : network(net) {}
+    ResourceManager(TransportationNetwork& net) : network(net) {
+        for (std::atomic<int>& index : resourceIndex) index.store(-1, std::memory_order_relaxed);
+        // Never reallocates, so Resource pointers stay valid while other threads allocate
+        resources.reserve(MAX_RESOURCE_TYPES);
+    }
 
-    bool allocateResources(const std::string& type, int qty, int sourceLocationId, int targetLocationId) {
-        auto it = resources.find(type);
-        if (it == resources.end()) return false;
+    /*
+        Thread-safe: the resource counter and the target location's inventory are
+        updated with atomic CAS operations and only the record append takes a
+        (short) lock, so several scheduler workers can allocate at once. The
+        network itself must not change while they do.
+    */
+    bool allocateResources(ResourceTypeId type, int qty, int sourceLocationId, int targetLocationId) {
+        RRP_METRIC_TIMER(timer, ALLOCATION_LATENCY);
+        Resource* found = getResource(type);
+        if (!found) {
+            RRP_METRIC_ADD(ALLOCATIONS_FAILED, 1);
+            return false;
+        }
 
-        Resource& res = it->second;
+        Resource& res = *found;
         if (res.allocate(qty)) {
-            allocationRecords.emplace_back(sourceLocationId, targetLocationId, type, qty, getCurrentTimestamp());
+            RRP_METRIC_ADD(ALLOCATIONS_SUCCEEDED, 1);
+            recordAllocation(sourceLocationId, targetLocationId, type, qty);
 
             // Add resources to the target location if available
             Location* targetLoc = network.getLocation(targetLocationId);
@@ -33,65 +99,288 @@ public:
 
             return true;
         }
+        RRP_METRIC_ADD(ALLOCATIONS_FAILED, 1);
         return false;
     }
 
-    bool transferResources(int sourceLocationId, int targetLocationId, const std::string& type, int qty) {
+    bool allocateResources(const std::string& type, int qty, int sourceLocationId, int targetLocationId) {
+        return allocateResources(ResourceTypeRegistry::instance().find(type), qty, sourceLocationId, targetLocationId);
+    }
+
+    /*
+        Like allocateResources, but the units travel: they are taken from the
+        central stock now and put on a shipment whose route holds `qty` load
+        (the unit the simulation sizes routes in) until it arrives, when the
+        scheduler adds them to the target. The allocation is recorded at
+        dispatch. False, with nothing allocated, if stock or a route is missing.
+    */
+    bool dispatchAllocation(ResourceTypeId type, int qty, int sourceLocationId, int targetLocationId,
+        ShipmentScheduler& shipments) {
+        RRP_METRIC_TIMER(timer, ALLOCATION_LATENCY);
+        Resource* res = getResource(type);
+        if (!res || !res->allocate(qty)) {
+            RRP_METRIC_ADD(ALLOCATIONS_FAILED, 1);
+            return false;
+        }
+        if (shipments.dispatch(sourceLocationId, targetLocationId, type, qty, qty) < 0) {
+            res->release(qty);
+            RRP_METRIC_ADD(ALLOCATIONS_FAILED, 1);
+            return false;
+        }
+        RRP_METRIC_ADD(ALLOCATIONS_SUCCEEDED, 1);
+        recordAllocation(sourceLocationId, targetLocationId, type, qty);
+        return true;
+    }
+
+    /*
+        Phase one of a transfer: checks the source stock, finds a route that can
+        carry the shipment's weight and holds both, the route load on the edges
+        (by handle) and the units taken out of the source. Nothing is held if
+        any part fails. Finish with commitTransfer or rollbackTransfer.
+    */
+    bool reserveTransfer(int sourceLocationId, int targetLocationId, ResourceTypeId type, int qty,
+        TransferReservation& r) {
+        r.held = false;
         Location* sourceLoc = network.getLocation(sourceLocationId);
         Location* targetLoc = network.getLocation(targetLocationId);
         Resource* res = getResource(type);
 
         if (!sourceLoc || !targetLoc || !res) return false;
         if (!sourceLoc->isOperational || !targetLoc->isOperational) return false;
+        if (sourceLoc->getAvailableQuantity(type) < qty) return false;
 
         // Calculate total weight of the transfer
         int totalWeight = qty * res->weight;
         if (totalWeight <= 0) return false;
 
-        // Find path with capacity for the total weight
-        auto path = network.findOptimalPath(sourceLocationId, targetLocationId, totalWeight);
-        if (path.empty()) return false;
+        // Find a path with capacity for the total weight and put the load on it
+        if (!network.reserveRoute(sourceLocationId, targetLocationId, totalWeight, r.route)) return false;
+        // The stock may have been drawn by someone else since the check above
+        if (!sourceLoc->useResource(type, qty)) {
+            network.releaseRoute(r.route);
+            return false;
+        }
 
-        // Verify all edges in the path can handle the load
-        bool canTransfer = true;
-        for (size_t i = 0; i < path.size() - 1; ++i) {
-            int from = path[i];
-            int to = path[i + 1];
-            const auto& edges = network.getEdges(from);
-            bool edgeFound = false;
-            for (const auto& edge : edges) {
-                if (edge.to == to && edge.canAddLoad(totalWeight)) {
-                    edgeFound = true;
-                    break;
-                }
-            }
-            if (!edgeFound) {
-                canTransfer = false;
-                break;
-            }
+        r.sourceLocationId = sourceLocationId;
+        r.targetLocationId = targetLocationId;
+        r.type = type;
+        r.quantity = qty;
+        r.held = true;
+        return true;
+    }
+
+    // Phase two: delivers the reserved units to the target and records the allocation
+    void commitTransfer(TransferReservation& r) {
+        if (!r.held) return;
+        if (Location* targetLoc = network.getLocation(r.targetLocationId)) targetLoc->addResource(r.type, r.quantity);
+        recordAllocation(r.sourceLocationId, r.targetLocationId, r.type, r.quantity);
+        r.route.held = false;   // the load stays on the route
+        r.held = false;
+    }
+
+    // Undoes a reservation: route load comes off the same edges, units go back to the source
+    void rollbackTransfer(TransferReservation& r) {
+        if (!r.held) return;
+        network.releaseRoute(r.route);
+        if (Location* sourceLoc = network.getLocation(r.sourceLocationId)) sourceLoc->addResource(r.type, r.quantity);
+        r.held = false;
+    }
+
+    bool transferResources(int sourceLocationId, int targetLocationId, ResourceTypeId type, int qty) {
+        if (!reserveTransfer(sourceLocationId, targetLocationId, type, qty, transferBuffer)) {
+            RRP_METRIC_ADD(TRANSFERS_FAILED, 1);
+            return false;
         }
-        if (!canTransfer) return false;
+        commitTransfer(transferBuffer);
+        RRP_METRIC_ADD(TRANSFERS_SUCCEEDED, 1);
+        return true;
+    }
 
-        // Update edge loads
-        for (size_t i = 0; i < path.size() - 1; ++i) {
-            int from = path[i];
-            int to = path[i + 1];
-            network.addLoadToEdge(from, to, totalWeight);
+    bool transferResources(int sourceLocationId, int targetLocationId, const std::string& type, int qty) {
+        return transferResources(sourceLocationId, targetLocationId, ResourceTypeRegistry::instance().find(type), qty);
+    }
+
+    /*
+        Moves units from one location's stock to another's and records the
+        allocation. Like allocateResources it leaves routing to the caller and
+        puts no load on the route; use transferResources to hold route capacity.
+    */
+    bool relocateStock(int sourceLocationId, int targetLocationId, ResourceTypeId type, int qty) {
+        Location* sourceLoc = network.getLocation(sourceLocationId);
+        Location* targetLoc = network.getLocation(targetLocationId);
+        if (!sourceLoc || !targetLoc || sourceLoc == targetLoc || !sourceLoc->useResource(type, qty)) {
+            RRP_METRIC_ADD(TRANSFERS_FAILED, 1);
+            return false;
         }
+        targetLoc->addResource(type, qty);
+        recordAllocation(sourceLocationId, targetLocationId, type, qty);
+        RRP_METRIC_ADD(TRANSFERS_SUCCEEDED, 1);
+        return true;
+    }
 
-        // Proceed with resource transfer
-        if (sourceLoc->useResource(type, qty)) {
-            targetLoc->addResource(type, qty);
-            allocationRecords.emplace_back(sourceLocationId, targetLocationId, type, qty, getCurrentTimestamp());
-            return true;
+    // relocateStock as a shipment: the units leave the source now and reach the target on arrival
+    bool dispatchRelocation(int sourceLocationId, int targetLocationId, ResourceTypeId type, int qty,
+        ShipmentScheduler& shipments) {
+        Location* sourceLoc = network.getLocation(sourceLocationId);
+        Location* targetLoc = network.getLocation(targetLocationId);
+        if (!sourceLoc || !targetLoc || sourceLoc == targetLoc || !sourceLoc->useResource(type, qty)) {
+            RRP_METRIC_ADD(TRANSFERS_FAILED, 1);
+            return false;
         }
-        return false;
+        if (shipments.dispatch(sourceLocationId, targetLocationId, type, qty, qty) < 0) {
+            sourceLoc->addResource(type, qty);
+            RRP_METRIC_ADD(TRANSFERS_FAILED, 1);
+            return false;
+        }
+        recordAllocation(sourceLocationId, targetLocationId, type, qty);
+        RRP_METRIC_ADD(TRANSFERS_SUCCEEDED, 1);
+        return true;
+    }
+
+    /*
+        The stock side of a shipment on its own: takes the units from the central
+        stock (from the source location's stock with fromLocalStock) and records
+        the allocation, without a route and without delivering. Journal replay
+        uses it; the units reach the target when the arrival record is replayed.
+    */
+    bool withdrawForShipment(int sourceLocationId, int targetLocationId, ResourceTypeId type, int qty,
+        bool fromLocalStock) {
+        if (fromLocalStock) {
+            Location* sourceLoc = network.getLocation(sourceLocationId);
+            if (!sourceLoc || !sourceLoc->useResource(type, qty)) return false;
+        }
+        else {
+            Resource* res = getResource(type);
+            if (!res || !res->allocate(qty)) return false;
+        }
+        recordAllocation(sourceLocationId, targetLocationId, type, qty);
+        return true;
+    }
+
+    /*
+        Operational locations other than the target that could send `qty` units of
+        `type` from their own stock without going below their critical level for
+        it, nearest to the target first (at most maxCount). Whether a route can
+        carry the shipment is left to the caller.
+    */
+    size_t findNearestSuppliers(int targetLocationId, ResourceTypeId type, int qty, size_t maxCount,
+        std::vector<SpatialNeighbor>& out) const {
+        out.clear();
+        const Location* targetLoc = network.getLocation(targetLocationId);
+        if (!targetLoc || type >= MAX_RESOURCE_TYPES || qty <= 0) return 0;
+        return network.findNearestLocations(targetLoc->latitude, targetLoc->longitude, maxCount,
+            [&](const Location& loc) {
+                return loc.id != targetLocationId && loc.isOperational &&
+                    loc.getAvailableQuantity(type) - qty >= loc.criticalLevels[type];
+            }, out);
+    }
+
+    /*
+        Turns a batch of transfer requests into flow demands. Each demand is
+        capped by what its source location still has in stock after the demands
+        before it in the batch (pass the batch in priority order). Requests whose
+        locations are offline or whose type is unknown get quantity 0.
+    */
+    std::vector<FlowDemand> makeTransferDemands(const std::vector<Request>& batch) const {
+        std::vector<FlowDemand> demands;
+        demands.reserve(batch.size());
+        std::unordered_map<long long, int> claimed;   // (source, type) -> units already promised
+        for (const Request& req : batch) {
+            FlowDemand d{ req.requestId, req.sourceLocationId, req.targetLocationId, req.resourceTypeId, 0, 0.0 };
+            const Location* sourceLoc = network.getLocation(req.sourceLocationId);
+            const Resource* res = getResource(req.resourceTypeId);
+            if (sourceLoc && res && sourceLoc->isOperational && network.isLocationOperational(req.targetLocationId)) {
+                long long key = static_cast<long long>(req.sourceLocationId) * MAX_RESOURCE_TYPES + req.resourceTypeId;
+                int& used = claimed[key];
+                int stock = sourceLoc->getAvailableQuantity(req.resourceTypeId) - used;
+                d.quantity = std::max(0, std::min(req.requiredQuantity, stock));
+                d.loadPerUnit = res->weight;
+                used += d.quantity;
+            }
+            demands.push_back(d);
+        }
+        return demands;
+    }
+
+    // Plans a batch of transfers together over the shared route capacities (nothing is committed)
+    FlowPlan planTransfers(const std::vector<FlowDemand>& demands,
+        const FlowPlannerOptions& options = FlowPlannerOptions()) {
+        return flowPlanner.plan(network, demands, options);
+    }
+
+    /*
+        Commits a plan from planTransfers: for every planned path the route loads
+        are added, stock moves from source to target and an allocation is
+        recorded. Each path's edges are checked again (by handle) against the
+        current loads and the stock first, so a plan that went stale only loses
+        the paths that no longer fit. Fills in `committed` per assignment and
+        returns the total number of units moved.
+    */
+    int commitTransferPlan(FlowPlan& plan, const std::vector<FlowDemand>& demands) {
+        bool sameLayout = plan.layout == network.layoutVersion();
+        int total = 0;
+        for (FlowAssignment& a : plan.assignments) {
+            a.committed = 0;
+            const FlowDemand& d = demands[a.demandIndex];
+            Location* sourceLoc = network.getLocation(d.sourceLocationId);
+            Location* targetLoc = network.getLocation(d.targetLocationId);
+            if (!sourceLoc || !targetLoc || !sourceLoc->isOperational || !targetLoc->isOperational) continue;
+
+            for (const FlowPath& fp : a.paths) {
+                if (sourceLoc->getAvailableQuantity(d.resourceType) < fp.quantity) break;
+                if (sameLayout) {
+                    if (!network.reserveEdges(fp.edges, fp.load)) continue;
+                }
+                else {
+                    // Routes were added since planning, so the handles are stale
+                    if (!routeCanCarry(fp.path, fp.load)) continue;
+                    for (size_t i = 0; i + 1 < fp.path.size(); ++i) {
+                        network.addLoadToEdge(fp.path[i], fp.path[i + 1], fp.load);
+                    }
+                }
+                if (!sourceLoc->useResource(d.resourceType, fp.quantity)) {
+                    // Stock ran short after the check: give the route load back
+                    if (sameLayout) network.releaseEdges(fp.edges, fp.load);
+                    else {
+                        for (size_t i = 0; i + 1 < fp.path.size(); ++i) {
+                            network.removeLoadFromEdge(fp.path[i], fp.path[i + 1], fp.load);
+                        }
+                    }
+                    break;
+                }
+                targetLoc->addResource(d.resourceType, fp.quantity);
+                recordAllocation(d.sourceLocationId, d.targetLocationId, d.resourceType, fp.quantity);
+                a.committed += fp.quantity;
+            }
+            total += a.committed;
+        }
+        return total;
     }
 
     // In the ResourceManager class:
     void addResource(const Resource& res) {
-        resources.emplace(res.type, res);
+        std::lock_guard<std::mutex> lock(registrationMutex);
+        if (resourceIndex[res.typeId].load(std::memory_order_relaxed) >= 0) return;   // first definition of a type wins
+        resources.push_back(res);
+        criticalTracker.watch(resources.back());
+        // Published only once the Resource is fully built, so lock-free readers never see half of it
+        resourceIndex[res.typeId].store(static_cast<int>(resources.size()) - 1, std::memory_order_release);
     }
+
+    /*
+        Alerts when the stock of `type` at a location drops below `level`
+        (0 removes the threshold). Returns false for an unknown location.
+    */
+    bool setLocationCriticalLevel(int locationId, ResourceTypeId type, int level) {
+        Location* loc = network.getLocation(locationId);
+        if (!loc) return false;
+        criticalTracker.watch(*loc, type, level);
+        return true;
+    }
+
+    // Below-critical set and transition callbacks (see CriticalLevelTracker)
+    CriticalLevelTracker& criticalLevels() { return criticalTracker; }
+    const CriticalLevelTracker& criticalLevels() const { return criticalTracker; }
     void printInventory() const {
         std::cout << "\n========== Central Resource Inventory ==========\n";
         std::cout << std::left << std::setw(15) << "Type"
@@ -103,11 +392,10 @@ public:
             << std::setw(10) << "Critical" << "\n";
         std::cout << std::string(85, '-') << "\n";
 
-        for (const auto& entry : resources) {
-            const Resource& res = entry.second;
-            std::cout << std::setw(15) << entry.first
-                << std::setw(15) << res.totalQuantity
-                << std::setw(15) << (res.totalQuantity - res.allocatedQuantity)
+        for (const Resource& res : resources) {
+            std::cout << std::setw(15) << res.type
+                << std::setw(15) << res.totalQuantity()
+                << std::setw(15) << res.getAvailableQuantity()
                 << std::setw(10) << (res.expiryDate > 0 ? std::to_string(res.expiryDate) + "d" : "N/A")
                 << std::setw(10) << res.unitCost
                 << std::setw(10) << res.weight
@@ -125,46 +413,78 @@ public:
             << std::setw(20) << "Timestamp" << "\n";
         std::cout << std::string(80, '-') << "\n";
 
-        for (const auto& record : allocationRecords) {
-            std::cout << std::setw(15) << std::get<0>(record)  // Source
-                << std::setw(15) << std::get<1>(record)  // Target
-                << std::setw(15) << std::get<2>(record)  // Resource Type
-                << std::setw(15) << std::get<3>(record)  // Quantity
-                << std::setw(20) << std::get<4>(record)  // Timestamp
+        allocationRecords.forEach([](int source, int target, ResourceTypeId type, int qty, Timestamp time) {
+            std::cout << std::setw(15) << source
+                << std::setw(15) << target
+                << std::setw(15) << resourceTypeName(type)
+                << std::setw(15) << qty
+                << std::setw(20) << formatTimestamp(time)
                 << "\n";
-        }
+        });
     }
 
+    // All registered resources, in the order they were added
+    const std::vector<Resource>& getResources() const { return resources; }
+
+    // Column store of all allocations, for aggregate queries (totals per type, target, time window)
+    const AllocationLedger& allocations() const { return allocationRecords; }
+
+    // Moves older allocation chunks to files in `directory` (see AllocationLedger::enableSpill)
+    void enableAllocationSpill(const std::string& directory, size_t residentChunks = 4) {
+        allocationRecords.enableSpill(directory, residentChunks);
+    }
+
+    // Number of resource types whose central stock is below their critical level (O(1))
+    int countBelowCriticalLevel() const {
+        return static_cast<int>(criticalTracker.centralAlertCount());
+    }
+
+    // Prints the current alerts; the tracker already holds them, so this is O(alerts)
     void checkCriticalLevels() const {
-        bool anyBelowCritical = false;
         std::cout << "\n========== Critical Resources Alert ==========\n";
 
-        for (const auto& entry : resources) {
-            const Resource& res = entry.second;
-            if (res.isBelowCriticalLevel()) {
-                std::cout << "WARNING: " << entry.first << " is below critical level! "
-                    << "Available: " << res.getAvailableQuantity()
-                    << " (Critical threshold: " << res.criticalLevel << ")\n";
-                anyBelowCritical = true;
+        std::vector<CriticalAlert> alerts = criticalTracker.currentAlerts();
+        for (const CriticalAlert& alert : alerts) {
+            if (alert.locationId == CriticalLevelTracker::CENTRAL_STOCK) {
+                std::cout << "WARNING: " << resourceTypeName(alert.type) << " is below critical level! ";
+            }
+            else {
+                const Location* loc = network.getLocation(alert.locationId);
+                std::cout << "WARNING: " << resourceTypeName(alert.type) << " at Loc" << alert.locationId
+                    << " (" << (loc ? loc->name : std::string("unknown")) << ") is below critical level! ";
             }
+            std::cout << "Available: " << alert.available
+                << " (Critical threshold: " << alert.criticalLevel << ")\n";
         }
 
-        if (!anyBelowCritical) {
+        if (alerts.empty()) {
             std::cout << "All resources are above critical levels.\n";
         }
     }
 
+    Resource* getResource(ResourceTypeId type) {
+        int index = type < MAX_RESOURCE_TYPES ? resourceIndex[type].load(std::memory_order_acquire) : -1;
+        return index >= 0 ? &resources[index] : nullptr;
+    }
+
+    const Resource* getResource(ResourceTypeId type) const {
+        return const_cast<ResourceManager*>(this)->getResource(type);
+    }
+
     Resource* getResource(const std::string& type) {
-        auto it = resources.find(type);
-        return it != resources.end() ? &it->second : nullptr;
+        return getResource(ResourceTypeRegistry::instance().find(type));
+    }
+
+    bool hasAvailableResource(ResourceTypeId type, int quantity) const {
+        const Resource* res = getResource(type);
+        return res && res->getAvailableQuantity() >= quantity;
     }
 
     bool hasAvailableResource(const std::string& type, int quantity) const {
-        auto it = resources.find(type);
-        return it != resources.end() && (it->second.totalQuantity - it->second.allocatedQuantity) >= quantity;
+        return hasAvailableResource(ResourceTypeRegistry::instance().find(type), quantity);
     }
 
-    int createSupplyRequest(int targetLocationId, const std::string& resourceType, int quantity) {
+    int createSupplyRequest(int targetLocationId, ResourceTypeId resourceType, int quantity) {
         Request req(nextRequestId++, 0, targetLocationId, resourceType, quantity, 5, Request::Type::SUPPLY);
         // Process supply request logic would go here
         return req.requestId;
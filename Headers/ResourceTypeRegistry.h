@@ -0,0 +1,76 @@
+// DSA concept used = String interning (hash table + dense id array)
+
+#pragma once
+#include <string>
+#include <array>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+// Small integer id standing for a resource type name ("Water", "Medicines", ...)
+using ResourceTypeId = std::uint16_t;
+
+// Upper bound on distinct resource types; inventories are flat arrays of this size
+constexpr int MAX_RESOURCE_TYPES = 64;
+constexpr ResourceTypeId INVALID_RESOURCE_TYPE = 0xFFFF;
+
+/*
+    Process-wide table that interns resource type names to ids 0..N-1.
+    Names are interned once at the API boundary (setup, parsing, user input);
+    everything on the hot path (inventories, requests, allocation records)
+    then works with the id and never hashes a string.
+
+    intern()/find() take a lock; name() is lock-free because a slot is never
+    changed after it was published.
+*/
+class ResourceTypeRegistry {
+    std::array<std::string, MAX_RESOURCE_TYPES> names;
+    std::unordered_map<std::string, ResourceTypeId> ids;
+    std::atomic<int> count{ 0 };
+    mutable std::mutex mutex;
+
+public:
+    static ResourceTypeRegistry& instance() {
+        static ResourceTypeRegistry registry;
+        return registry;
+    }
+
+    // Returns the id for `name`, registering it on first use
+    ResourceTypeId intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+
+        int next = count.load(std::memory_order_relaxed);
+        if (next >= MAX_RESOURCE_TYPES) throw std::runtime_error("Too many resource types: " + name);
+        names[next] = name;
+        ids.emplace(name, static_cast<ResourceTypeId>(next));
+        count.store(next + 1, std::memory_order_release);
+        return static_cast<ResourceTypeId>(next);
+    }
+
+    // Id of an already registered name, or INVALID_RESOURCE_TYPE
+    ResourceTypeId find(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ids.find(name);
+        return it != ids.end() ? it->second : INVALID_RESOURCE_TYPE;
+    }
+
+    const std::string& name(ResourceTypeId id) const {
+        static const std::string unknown = "Unknown";
+        return id < count.load(std::memory_order_acquire) ? names[id] : unknown;
+    }
+
+    int size() const { return count.load(std::memory_order_acquire); }
+};
+
+// Shorthands used throughout the code base
+inline ResourceTypeId internResourceType(const std::string& name) {
+    return ResourceTypeRegistry::instance().intern(name);
+}
+
+inline const std::string& resourceTypeName(ResourceTypeId id) {
+    return ResourceTypeRegistry::instance().name(id);
+}
@@ -0,0 +1,271 @@
+// DSA concept used = Shortest-path trees + LRU cache + dynamic (incremental) shortest paths
+
+#pragma once
+#include "SearchWorkspace.h"
+#include <vector>
+#include <climits>
+#include <cstdint>
+
+/*
+    Result of one full Dijkstra run from a source (all indices are dense node ids).
+    Any destination's route is recovered by walking `parent` back to the source,
+    so requests that share a depot share one search.
+*/
+struct ShortestPathTree {
+    int source = -1;
+    std::vector<int> dist;          // INT_MAX when unreachable
+    std::vector<int> parent;        // previous node on the route, -1 for source/unreachable
+    std::vector<int> parentEdge;    // CSR edge used to enter the node, -1 for source/unreachable
+
+    // Loads accepted by this tree: every q in (minLoadExclusive, maxLoad] sees exactly
+    // the same set of usable edges, so the tree answers all of them.
+    int minLoadExclusive = INT_MIN;
+    int maxLoad = INT_MAX;
+    int load = 0;                   // a load inside the band, used when repairing
+
+    std::uint64_t lastUsed = 0;
+
+    bool accepts(int q) const { return q > minLoadExclusive && q <= maxLoad; }
+    bool reaches(int node) const { return dist[node] != INT_MAX; }
+};
+
+/*
+    Bounded cache of shortest-path trees keyed by (source, load band).
+
+    TransportationNetwork reports every edge whose usability changed (route
+    closed/reopened, load added, location taken offline). Changes that cannot
+    affect a tree leave it alone. Otherwise the tree is repaired in place,
+    Ramalingam-Reps style, touching only the part that depends on the edge:
+    - a tree edge became unusable: only the subtree below it is re-settled,
+      starting from its best entry points from the rest of the tree;
+    - an off-tree edge became usable and shortens a route: the improvement is
+      propagated outwards from that edge until distances stop dropping.
+    A change that only affects part of a tree's load band narrows the band to
+    the side where the tree is still exact, so no search is needed at all.
+*/
+class RouteCache {
+    std::vector<ShortestPathTree> trees;
+    size_t maxTrees;
+    std::uint64_t clock = 0;
+
+    // Repair scratch, kept across calls so repairs do not allocate
+    std::vector<std::uint8_t> affected;
+    std::vector<int> subtree;
+
+    // Keeps `load` inside the band after it was narrowed
+    static void clampLoad(ShortestPathTree& t) {
+        if (t.load > t.maxLoad) t.load = t.maxLoad;
+        if (t.load <= t.minLoadExclusive) t.load = t.minLoadExclusive + 1;
+    }
+
+    // Splits the band at `limit` and keeps the lower part (limit usable) or the upper part
+    static void keepLower(ShortestPathTree& t, int limit) { t.maxLoad = limit; clampLoad(t); }
+    static void keepUpper(ShortestPathTree& t, int limit) { t.minLoadExclusive = limit; clampLoad(t); }
+
+    /*
+        Applies one edge change to one tree. `before`/`after` are the edge's
+        load limits (largest load it can carry, INT_MIN when unusable). Within a
+        band every edge is either usable for all loads or for none, so a limit
+        is either >= maxLoad (usable) or <= minLoadExclusive (unusable).
+    */
+    template <typename Graph>
+    void applyEdgeChange(ShortestPathTree& t, const Graph& g, int fromIndex, int edge, int before, int after) {
+        int lo = t.minLoadExclusive;
+        int hi = t.maxLoad;
+        bool wasUsable = before >= hi;
+        bool isUsable = after >= hi;
+        bool partly = after > lo && after < hi;   // usable for some loads of the band only
+        int head = g.to[edge];
+
+        if (wasUsable) {
+            bool onTree = t.parentEdge[head] == edge;
+            if (isUsable) return;
+            if (partly) {
+                // The lower part still sees the edge; off-tree, either part is exact
+                if (onTree || t.load <= after) keepLower(t, after);
+                else keepUpper(t, after);
+                return;
+            }
+            if (onTree) repairIncrease(t, g, head);
+            return;
+        }
+
+        if (!isUsable && !partly) return;
+        bool shortens = t.reaches(fromIndex) && t.dist[fromIndex] + g.cost[edge] < t.dist[head];
+        if (partly) {
+            // The upper part does not see the edge; if it is no shortcut, both parts are exact
+            if (shortens || t.load > after) keepUpper(t, after);
+            else keepLower(t, after);
+            return;
+        }
+        if (shortens) repairDecrease(t, g, fromIndex, edge);
+    }
+
+    /*
+        The edge into `head` left the tree. Re-settles the subtree rooted at head:
+        each node in it first takes its best entry from outside the subtree, then
+        a Dijkstra restricted to the subtree finishes the job.
+    */
+    template <typename Graph>
+    void repairIncrease(ShortestPathTree& t, const Graph& g, int head) {
+        int n = g.nodeCount();
+        if (static_cast<int>(affected.size()) < n) affected.resize(n, 0);
+
+        // Collect the subtree through the children of each node
+        subtree.clear();
+        subtree.push_back(head);
+        affected[head] = 1;
+        for (size_t i = 0; i < subtree.size(); ++i) {
+            int u = subtree[i];
+            for (int e = g.rowStart[u]; e < g.rowStart[u + 1]; ++e) {
+                int w = g.to[e];
+                if (t.parentEdge[w] == e && !affected[w]) {
+                    affected[w] = 1;
+                    subtree.push_back(w);
+                }
+            }
+        }
+
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        ws.prepare(n);
+        for (int v : subtree) {
+            t.dist[v] = INT_MAX;
+            t.parent[v] = -1;
+            t.parentEdge[v] = -1;
+        }
+        // Best entry into each affected node from the unaffected part of the tree
+        for (int v : subtree) {
+            for (int e = g.rowStart[v]; e < g.rowStart[v + 1]; ++e) {
+                int incoming = g.twin[e];
+                int w = g.to[e];
+                if (affected[w] || !t.reaches(w) || !g.canAddLoad(incoming, t.load)) continue;
+                int candidate = t.dist[w] + g.cost[incoming];
+                if (candidate < t.dist[v]) {
+                    t.dist[v] = candidate;
+                    t.parent[v] = w;
+                    t.parentEdge[v] = incoming;
+                }
+            }
+            if (t.reaches(v)) ws.heap.pushOrDecrease(v, t.dist[v]);
+        }
+        settle(t, g, ws);
+
+        for (int v : subtree) affected[v] = 0;
+    }
+
+    // A usable edge from -> to[edge] now gives a shorter route; push the gain outwards
+    template <typename Graph>
+    void repairDecrease(ShortestPathTree& t, const Graph& g, int fromIndex, int edge) {
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        ws.prepare(g.nodeCount());
+        int head = g.to[edge];
+        t.dist[head] = t.dist[fromIndex] + g.cost[edge];
+        t.parent[head] = fromIndex;
+        t.parentEdge[head] = edge;
+        ws.heap.pushOrDecrease(head, t.dist[head]);
+        settle(t, g, ws);
+    }
+
+    // Dijkstra on the tree's own arrays from whatever is queued in the heap
+    template <typename Graph>
+    static void settle(ShortestPathTree& t, const Graph& g, SearchWorkspace& ws) {
+        while (!ws.heap.empty()) {
+            int du = ws.heap.topKey();
+            int u = ws.heap.pop();
+            if (du > t.dist[u]) continue;
+            for (int e = g.rowStart[u]; e < g.rowStart[u + 1]; ++e) {
+                if (!g.canAddLoad(e, t.load)) continue;
+                int v = g.to[e];
+                int candidate = du + g.cost[e];
+                if (candidate < t.dist[v]) {
+                    t.dist[v] = candidate;
+                    t.parent[v] = u;
+                    t.parentEdge[v] = e;
+                    ws.heap.pushOrDecrease(v, candidate);
+                }
+            }
+        }
+    }
+
+public:
+    explicit RouteCache(size_t maxTrees = 32) : maxTrees(maxTrees) { trees.reserve(maxTrees); }
+
+    void clear() { trees.clear(); }
+    size_t size() const { return trees.size(); }
+
+    /*
+        Returns the cached tree for (source, load), building it with one full
+        Dijkstra run on a miss. When the cache is full the least recently used
+        tree is replaced. The reference stays valid until the next lookup that
+        misses the cache (which may rebuild this very tree) or the next change
+        to the network (which repairs trees in place).
+    */
+    template <typename Graph>
+    const ShortestPathTree& lookup(const Graph& g, int source, int load) {
+        // Room for every tree up front (a copied cache loses its capacity), so adding one never moves the others
+        if (trees.capacity() < maxTrees) trees.reserve(maxTrees);
+        ++clock;
+        for (ShortestPathTree& t : trees) {
+            if (t.source == source && t.accepts(load)) {
+                t.lastUsed = clock;
+                return t;
+            }
+        }
+
+        ShortestPathTree* slot = nullptr;
+        if (trees.size() < maxTrees) {
+            trees.emplace_back();
+            slot = &trees.back();
+        }
+        else {
+            slot = &trees.front();
+            for (ShortestPathTree& t : trees) {
+                if (t.lastUsed < slot->lastUsed) slot = &t;
+            }
+        }
+        build(g, source, load, *slot);
+        slot->lastUsed = clock;
+        return *slot;
+    }
+
+    // Runs the search and records the band of loads that see the same usable edges
+    template <typename Graph>
+    static void build(const Graph& g, int source, int load, ShortestPathTree& t) {
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        runDijkstra(g, ws, source, -1, load);
+
+        int n = g.nodeCount();
+        t.source = source;
+        t.load = load;
+        t.dist.resize(n);
+        t.parent.resize(n);
+        t.parentEdge.resize(n);
+        for (int v = 0; v < n; ++v) {
+            t.dist[v] = ws.distanceTo(v);
+            t.parent[v] = ws.predecessor(v);
+            t.parentEdge[v] = ws.predecessorEdge(v);
+        }
+
+        t.minLoadExclusive = INT_MIN;
+        t.maxLoad = INT_MAX;
+        for (int e = 0; e < g.edgeCount(); ++e) {
+            int limit = g.loadLimit(e);
+            if (limit == INT_MIN) continue;
+            if (limit >= load) t.maxLoad = std::min(t.maxLoad, limit);
+            else t.minLoadExclusive = std::max(t.minLoadExclusive, limit);
+        }
+    }
+
+    /*
+        Called by the network after the usability of `edge` (leaving `fromIndex`)
+        changed; `oldLimit` is its load limit before the change.
+    */
+    template <typename Graph>
+    void onEdgeChanged(const Graph& g, int fromIndex, int edge, int oldLimit) {
+        int newLimit = g.loadLimit(edge);
+        if (newLimit == oldLimit) return;
+        for (ShortestPathTree& t : trees) {
+            applyEdgeChange(t, g, fromIndex, edge, oldLimit, newLimit);
+        }
+    }
+};
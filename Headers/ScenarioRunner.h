@@ -0,0 +1,174 @@
+// DSA concept used = Parallel Monte Carlo simulation with per-scenario seed streams
+
+#pragma once
+#include "ResourceAllocationSimulation.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+struct ScenarioRunOptions {
+    int scenarios = 100;
+    int days = 10;
+    std::uint64_t baseSeed = 1;         // scenario i runs with ScenarioRunner::scenarioSeed(baseSeed, i)
+    std::string logDirectory;           // empty = no logs, else one scenario_<i>.log per run
+    SimulationConfig base;              // settings every scenario starts from (scale, network, transit...);
+                                        // seed, console, reports, log and metrics files are set per run
+};
+
+struct ScenarioResult {
+    int index = 0;
+    std::uint64_t seed = 0;
+    bool completed = false;             // false if the run threw; see error
+    std::string error;
+    SimulationStats stats;
+};
+
+// Distribution of one metric over all completed scenarios
+struct MetricSummary {
+    double mean = 0, stddev = 0;
+    double min = 0, p5 = 0, median = 0, p95 = 0, max = 0;
+
+    static MetricSummary of(std::vector<double> values) {
+        MetricSummary m;
+        if (values.empty()) return m;
+        std::sort(values.begin(), values.end());
+        double sum = 0;
+        for (double v : values) sum += v;
+        m.mean = sum / values.size();
+        double squares = 0;
+        for (double v : values) squares += (v - m.mean) * (v - m.mean);
+        m.stddev = values.size() > 1 ? std::sqrt(squares / (values.size() - 1)) : 0.0;
+        // Nearest-rank percentiles
+        auto rank = [&](double p) {
+            size_t k = static_cast<size_t>(std::ceil(p * values.size()));
+            return values[std::min(values.size() - 1, k > 0 ? k - 1 : 0)];
+        };
+        m.min = values.front();
+        m.p5 = rank(0.05);
+        m.median = rank(0.5);
+        m.p95 = rank(0.95);
+        m.max = values.back();
+        return m;
+    }
+};
+
+struct ScenarioSummary {
+    std::vector<ScenarioResult> results;   // in scenario order
+    int completed = 0;
+
+    MetricSummary fulfillmentRate;         // fulfilled / handled requests
+    MetricSummary deliveryRate;            // delivered / requested units
+    MetricSummary rejectedNoStock;         // requests turned down for lack of stock
+    MetricSummary rejectedNoRoute;
+    MetricSummary criticalResourceDays;
+    MetricSummary unitsLost;               // stock destroyed by shortage events
+    MetricSummary routeDisruptions;
+    MetricSummary locationDisruptions;
+
+    void print(std::ostream& out = std::cout) const {
+        out << "\n========== Scenario Summary (" << completed << "/" << results.size()
+            << " runs completed) ==========\n";
+        out << std::left << std::setw(24) << "Metric" << std::right
+            << std::setw(10) << "Mean" << std::setw(10) << "StdDev" << std::setw(10) << "Min"
+            << std::setw(10) << "P5" << std::setw(10) << "Median" << std::setw(10) << "P95"
+            << std::setw(10) << "Max" << "\n";
+        auto row = [&](const char* name, const MetricSummary& m) {
+            out << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(3)
+                << std::setw(10) << m.mean << std::setw(10) << m.stddev << std::setw(10) << m.min
+                << std::setw(10) << m.p5 << std::setw(10) << m.median << std::setw(10) << m.p95
+                << std::setw(10) << m.max << "\n";
+        };
+        row("Fulfillment rate", fulfillmentRate);
+        row("Delivery rate", deliveryRate);
+        row("Rejected (no stock)", rejectedNoStock);
+        row("Rejected (no route)", rejectedNoRoute);
+        row("Critical resource-days", criticalResourceDays);
+        row("Units lost", unitsLost);
+        row("Route disruptions", routeDisruptions);
+        row("Location disruptions", locationDisruptions);
+        out.unsetf(std::ios::fixed);
+        for (const ScenarioResult& r : results) {
+            if (!r.completed) out << "Scenario " << r.index << " (seed " << r.seed << ") failed: " << r.error << "\n";
+        }
+    }
+};
+
+/*
+    Runs many independent what-if simulations in parallel and aggregates them.
+
+    Every scenario builds its own ResourceAllocationSimulation with console
+    output and report files off and its own log file (or none), so runs share
+    no RNG, stream or file. Scenario i always gets the same seed for the same
+    base seed, and results are stored by index, so the summary does not depend
+    on the number of threads or on scheduling. Re-running one scenario with
+    SimulationConfig::seed = result.seed reproduces it exactly.
+*/
+class ScenarioRunner {
+    ThreadPool pool;
+
+public:
+    explicit ScenarioRunner(size_t threadCount = 0) : pool(threadCount) {}
+
+    size_t threadCount() const { return pool.size(); }
+
+    static std::uint64_t scenarioSeed(std::uint64_t baseSeed, int index) {
+        std::uint64_t seed = mixSeed(baseSeed, static_cast<std::uint64_t>(index));
+        return seed != 0 ? seed : 1;   // 0 would mean "random"
+    }
+
+    ScenarioSummary run(const ScenarioRunOptions& options) {
+        ScenarioSummary summary;
+        summary.results.resize(static_cast<size_t>(std::max(0, options.scenarios)));
+
+        pool.parallelFor(summary.results.size(), [&](size_t i) {
+            ScenarioResult& result = summary.results[i];
+            result.index = static_cast<int>(i);
+            result.seed = scenarioSeed(options.baseSeed, result.index);
+
+            SimulationConfig config = options.base;
+            config.seed = result.seed;
+            config.consoleOutput = false;
+            config.writeReports = false;
+            config.metricsFile.clear();     // the registry is per process; write it once after run()
+            config.logFile = options.logDirectory.empty() ? std::string()
+                : options.logDirectory + "/scenario_" + std::to_string(i) + ".log";
+            try {
+                ResourceAllocationSimulation simulation(config);
+                simulation.runSimulation(options.days);
+                result.stats = simulation.stats();
+                result.completed = true;
+            }
+            catch (const std::exception& e) {
+                result.error = e.what();
+            }
+        });
+
+        std::vector<double> fulfillment, delivery, noStock, noRoute, critical, lost, routes, locations;
+        for (const ScenarioResult& r : summary.results) {
+            if (!r.completed) continue;
+            ++summary.completed;
+            fulfillment.push_back(r.stats.fulfillmentRate());
+            delivery.push_back(r.stats.deliveryRate());
+            noStock.push_back(r.stats.rejectedNoStock);
+            noRoute.push_back(r.stats.rejectedNoRoute);
+            critical.push_back(r.stats.criticalResourceDays);
+            lost.push_back(static_cast<double>(r.stats.disruptions.unitsLost));
+            routes.push_back(r.stats.disruptions.routeDisruptions);
+            locations.push_back(r.stats.disruptions.locationDisruptions);
+        }
+        summary.fulfillmentRate = MetricSummary::of(std::move(fulfillment));
+        summary.deliveryRate = MetricSummary::of(std::move(delivery));
+        summary.rejectedNoStock = MetricSummary::of(std::move(noStock));
+        summary.rejectedNoRoute = MetricSummary::of(std::move(noRoute));
+        summary.criticalResourceDays = MetricSummary::of(std::move(critical));
+        summary.unitsLost = MetricSummary::of(std::move(lost));
+        summary.routeDisruptions = MetricSummary::of(std::move(routes));
+        summary.locationDisruptions = MetricSummary::of(std::move(locations));
+        return summary;
+    }
+};
@@ -0,0 +1,211 @@
+// DSA concept used = Indexed d-ary heap + generation-stamped arrays
+
+#pragma once
+#include "Metrics.h"
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+
+/*
+    Min-heap over dense node indices with decrease-key.
+    Each node is in the heap at most once; `position` tells where, so a shorter
+    distance found later moves the existing entry up instead of pushing a duplicate.
+    A 4-ary layout keeps the tree shallow and the children of a node in one cache line.
+*/
+class IndexedDaryHeap {
+    static constexpr int ARITY = 4;
+
+    std::vector<int> keys;       // heap-ordered keys (distances)
+    std::vector<int> nodes;      // node stored at each heap slot
+    std::vector<int> position;   // node -> heap slot, -1 when not in the heap
+
+    void place(int slot, int key, int node) {
+        keys[slot] = key;
+        nodes[slot] = node;
+        position[node] = slot;
+    }
+
+    void siftUp(int slot) {
+        int key = keys[slot];
+        int node = nodes[slot];
+        while (slot > 0) {
+            int parent = (slot - 1) / ARITY;
+            if (keys[parent] <= key) break;
+            place(slot, keys[parent], nodes[parent]);
+            slot = parent;
+        }
+        place(slot, key, node);
+    }
+
+    void siftDown(int slot) {
+        int size = static_cast<int>(keys.size());
+        int key = keys[slot];
+        int node = nodes[slot];
+        while (true) {
+            int first = slot * ARITY + 1;
+            if (first >= size) break;
+            int last = std::min(first + ARITY, size);
+            int best = first;
+            for (int c = first + 1; c < last; ++c) {
+                if (keys[c] < keys[best]) best = c;
+            }
+            if (keys[best] >= key) break;
+            place(slot, keys[best], nodes[best]);
+            slot = best;
+        }
+        place(slot, key, node);
+    }
+
+public:
+    // Makes room for node indices 0..n-1; only allocates when the graph grew
+    void reserveNodes(int n) {
+        if (static_cast<int>(position.size()) < n) {
+            position.resize(n, -1);
+            keys.reserve(n);
+            nodes.reserve(n);
+        }
+    }
+
+    // Empties the heap in O(entries left), keeping all buffers
+    void clear() {
+        for (int node : nodes) position[node] = -1;
+        keys.clear();
+        nodes.clear();
+    }
+
+    bool empty() const { return keys.empty(); }
+    bool contains(int node) const { return position[node] >= 0; }
+
+    // Inserts the node, or lowers its key if it is already queued with a larger one
+    void pushOrDecrease(int node, int key) {
+        int slot = position[node];
+        if (slot < 0) {
+            keys.push_back(key);
+            nodes.push_back(node);
+            siftUp(static_cast<int>(keys.size()) - 1);
+        }
+        else if (key < keys[slot]) {
+            keys[slot] = key;
+            siftUp(slot);
+        }
+    }
+
+    int topKey() const { return keys.front(); }
+    int topNode() const { return nodes.front(); }
+
+    // Removes and returns the node with the smallest key
+    int pop() {
+        int top = nodes.front();
+        position[top] = -1;
+        int lastKey = keys.back();
+        int lastNode = nodes.back();
+        keys.pop_back();
+        nodes.pop_back();
+        if (!keys.empty()) {
+            keys[0] = lastKey;
+            nodes[0] = lastNode;
+            siftDown(0);
+        }
+        return top;
+    }
+};
+
+/*
+    Scratch state for one shortest-path search, reused across queries.
+
+    dist/prev are flat arrays indexed by dense node id. Instead of clearing them
+    before every search, each entry carries the generation that wrote it; bumping
+    `generation` invalidates everything at once, so a reset is O(1).
+    Buffers only grow, so once warmed up a query performs no heap allocations.
+*/
+class SearchWorkspace {
+    std::vector<int> dist;
+    std::vector<int> prev;
+    std::vector<int> via;        // edge index used to reach the node
+    std::vector<std::uint32_t> stamp;
+    std::uint32_t generation = 0;
+
+public:
+    IndexedDaryHeap heap;
+
+    // Starts a new search over a graph with n nodes
+    void prepare(int n) {
+        if (static_cast<int>(stamp.size()) < n) {
+            dist.resize(n);
+            prev.resize(n);
+            via.resize(n);
+            stamp.resize(n, 0);
+        }
+        heap.reserveNodes(n);
+        heap.clear();
+        if (++generation == 0) {
+            // Stamp counter wrapped around; wipe the stamps once
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+    }
+
+    bool reached(int node) const { return stamp[node] == generation; }
+    int distanceTo(int node) const { return reached(node) ? dist[node] : INT_MAX; }
+    int predecessor(int node) const { return reached(node) ? prev[node] : -1; }
+    int predecessorEdge(int node) const { return reached(node) ? via[node] : -1; }
+
+    void setDistance(int node, int d, int parent, int edge = -1) {
+        stamp[node] = generation;
+        dist[node] = d;
+        prev[node] = parent;
+        via[node] = edge;
+    }
+
+    // One workspace per thread, so concurrent searches never share scratch space
+    static SearchWorkspace& forThisThread() {
+        thread_local SearchWorkspace workspace;
+        return workspace;
+    }
+};
+
+/*
+    A* over any CSR-shaped graph (rowStart / to columns plus canAddLoad(edge, load)),
+    with per-edge weights taken from `weight` (any indexable column: a vector, or
+    a pointer into a mapped file). Edges that cannot carry
+    `requiredCapacity` are skipped. `heuristic(v)` must be a consistent lower bound on
+    the remaining weight to `destination` (0 everywhere gives plain Dijkstra).
+    Stops as soon as `destination` is settled; pass -1 to settle every reachable node.
+    Returns the number of nodes settled.
+*/
+template <typename Graph, typename Weights, typename Heuristic>
+int runAStar(const Graph& g, const Weights& weight, SearchWorkspace& ws,
+    int source, int destination, int requiredCapacity, Heuristic heuristic) {
+    ws.prepare(g.nodeCount());
+    ws.setDistance(source, 0, -1);
+    ws.heap.pushOrDecrease(source, heuristic(source));
+
+    int settled = 0, relaxed = 0;
+    while (!ws.heap.empty()) {
+        int u = ws.heap.pop();
+        ++settled;
+        if (u == destination) break;
+
+        int du = ws.distanceTo(u);
+        for (int e = g.rowStart[u]; e < g.rowStart[u + 1]; ++e) {
+            if (!g.canAddLoad(e, requiredCapacity)) continue;
+            int v = g.to[e];
+            int candidate = du + weight[e];
+            if (candidate < ws.distanceTo(v)) {
+                ws.setDistance(v, candidate, u, e);
+                ws.heap.pushOrDecrease(v, candidate + heuristic(v));
+                ++relaxed;
+            }
+        }
+    }
+    RRP_METRIC_ADD(PATH_NODES_SETTLED, settled);
+    RRP_METRIC_ADD(PATH_EDGES_RELAXED, relaxed);
+    return settled;
+}
+
+// Plain Dijkstra over the graph's `cost` column
+template <typename Graph>
+int runDijkstra(const Graph& g, SearchWorkspace& ws, int source, int destination, int requiredCapacity) {
+    return runAStar(g, g.cost, ws, source, destination, requiredCapacity, [](int) { return 0; });
+}
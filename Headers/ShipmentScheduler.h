@@ -0,0 +1,173 @@
+// DSA concept used = Discrete-event simulation on a timing wheel, slab of in-flight shipments
+
+#pragma once
+#include "TimingWheel.h"
+#include "TransportationNetwork.h"
+#include "ResourceTypeRegistry.h"
+#include "Metrics.h"
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+struct ShipmentSchedulerOptions {
+    int ticksPerHour = 60;        // time resolution: 60 = one tick per simulated minute
+    double speedKmh = 40.0;       // travel speed on every route; a hop takes Edge::distance / speed
+    size_t wheelSlots = 4096;     // ticks covered by the wheel; later arrivals wait in the overflow heap
+};
+
+// A shipment on its way, as reported on arrival
+struct Shipment {
+    int id = 0;
+    int sourceLocationId = -1;
+    int targetLocationId = -1;
+    ResourceTypeId type = INVALID_RESOURCE_TYPE;
+    int quantity = 0;
+    SimTick departure = 0;
+    SimTick arrival = 0;          // tick the last hop ends
+    RouteReservation route;       // load still held on the edges not yet passed
+    std::vector<SimTick> hopTicks;   // travel time of each edge of the route
+};
+
+struct ShipmentStats {
+    long long dispatched = 0;
+    long long delivered = 0;
+    long long hops = 0;           // edges passed (each gives its load back)
+    long long unitsDelivered = 0;
+    size_t peakInTransit = 0;
+};
+
+/*
+    Moves shipments through the network in simulated time. dispatch() reserves
+    a route for the shipment's load (TransportationNetwork::reserveRoute) and
+    schedules its first hop; every hop event takes the load off the edge just
+    passed and schedules the next one, and the last hop adds the units to the
+    target location's stock. Route load is therefore held only while a
+    shipment still has to use the route, instead of staying on it for good.
+
+    Stock leaves the source before dispatch(), which is the caller's part (see
+    ResourceManager::dispatchAllocation and dispatchRelocation). Shipments live
+    in a slab whose slots and route buffers are reused, so a steady stream of
+    shipments does not allocate. Single-threaded, like the network it changes.
+*/
+class ShipmentScheduler {
+public:
+    using ArrivalCallback = std::function<void(const Shipment&)>;
+
+private:
+    TransportationNetwork& network;
+    ShipmentSchedulerOptions options;
+    TimingWheel<int> events;      // slab slot of the shipment whose current hop ends at that tick
+    std::vector<Shipment> slab;
+    std::vector<int> freeSlots;
+    size_t active = 0;
+    int nextShipmentId = 1;
+    ShipmentStats counters;
+    std::vector<ArrivalCallback> callbacks;
+    Shipment delivered;           // the shipment being reported; swapped out of the slab, keeps buffers warm
+
+    void arrive(SimTick tick, int slot) {
+        Shipment& s = slab[slot];
+        network.releaseNextHop(s.route);
+        ++counters.hops;
+        if (s.route.held) {
+            events.schedule(tick + s.hopTicks[s.route.released], slot);
+            return;
+        }
+
+        if (Location* target = network.getLocation(s.targetLocationId)) target->addResource(s.type, s.quantity);
+        ++counters.delivered;
+        counters.unitsDelivered += s.quantity;
+        RRP_METRIC_ADD(SHIPMENTS_DELIVERED, 1);
+
+        // Free the slot before reporting: a callback may dispatch, which can grow the slab
+        std::swap(delivered, s);
+        freeSlots.push_back(slot);
+        --active;
+        for (const ArrivalCallback& callback : callbacks) callback(delivered);
+    }
+
+public:
+    explicit ShipmentScheduler(TransportationNetwork& net,
+        const ShipmentSchedulerOptions& opts = ShipmentSchedulerOptions())
+        : network(net), options(opts), events(opts.wheelSlots) {
+        options.ticksPerHour = std::max(1, options.ticksPerHour);
+        if (!(options.speedKmh > 0)) options.speedKmh = ShipmentSchedulerOptions().speedKmh;
+    }
+
+    // Current simulated time: the first tick whose events have not run yet
+    SimTick now() const { return events.now(); }
+    int ticksPerDay() const { return 24 * options.ticksPerHour; }
+
+    // Ticks needed for `km` at the configured speed, at least one
+    SimTick travelTicks(double km) const {
+        double ticks = std::ceil(km / options.speedKmh * options.ticksPerHour);
+        return std::max<SimTick>(1, static_cast<SimTick>(ticks));
+    }
+
+    /*
+        Sends `quantity` units of `type` from source to target, leaving now().
+        The cheapest route that can take `load` more is reserved for the whole
+        trip. Returns the shipment id, or -1 if no route can carry the load
+        (nothing is held then).
+    */
+    int dispatch(int sourceLocationId, int targetLocationId, ResourceTypeId type, int quantity, int load) {
+        int slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            slot = static_cast<int>(slab.size());
+            slab.emplace_back();
+        }
+
+        Shipment& s = slab[slot];
+        if (!network.reserveRoute(sourceLocationId, targetLocationId, load, s.route)) {
+            freeSlots.push_back(slot);
+            return -1;
+        }
+
+        const CsrGraph& g = network.graph();
+        s.hopTicks.clear();
+        SimTick total = 0;
+        for (int e : s.route.edges) {
+            s.hopTicks.push_back(travelTicks(g.distance[e]));
+            total += s.hopTicks.back();
+        }
+        s.id = nextShipmentId++;
+        s.sourceLocationId = sourceLocationId;
+        s.targetLocationId = targetLocationId;
+        s.type = type;
+        s.quantity = quantity;
+        s.departure = now();
+        s.arrival = s.departure + total;
+        events.schedule(s.departure + s.hopTicks[0], slot);
+
+        ++active;
+        ++counters.dispatched;
+        counters.peakInTransit = std::max(counters.peakInTransit, active);
+        RRP_METRIC_ADD(SHIPMENTS_DISPATCHED, 1);
+        return s.id;
+    }
+
+    /*
+        Runs every hop and arrival up to and including tick `until`, in time
+        order, and leaves the clock after it. Returns the number of shipments
+        delivered.
+    */
+    size_t advanceTo(SimTick until) {
+        long long before = counters.delivered;
+        events.advanceTo(until, [this](SimTick tick, int slot) { arrive(tick, slot); });
+        return static_cast<size_t>(counters.delivered - before);
+    }
+
+    /*
+        Called with each shipment as it is delivered, after the target's stock was
+        updated. A callback may dispatch new shipments but must not call advanceTo.
+    */
+    void onArrival(ArrivalCallback callback) { callbacks.push_back(std::move(callback)); }
+
+    size_t inTransit() const { return active; }
+    const ShipmentStats& stats() const { return counters; }
+};
@@ -0,0 +1,234 @@
+// DSA concept used = Uniform grid (geohash-style bucketing of latitude/longitude) with ring search
+
+#pragma once
+#include "Location.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+// A location found by a spatial query and its great-circle distance from the query point
+struct SpatialNeighbor {
+    int id;
+    double distanceKm;
+};
+
+/*
+    Buckets points into square latitude/longitude cells so that nearest and
+    radius queries only look at the cells around the query point.
+
+    Insertion is O(1) (points are only ever added, like locations). Nearest
+    queries walk rings of cells outward from the query cell and stop as soon
+    as no point outside the rings seen so far can beat the current answer; the
+    bound used for that is a true lower bound on the great-circle distance, so
+    results match a brute-force haversine scan. When the rings get larger than
+    the number of occupied cells the search finishes with a scan of those
+    cells instead, so sparse data never costs more than a linear pass.
+
+    Longitudes are not wrapped at the antimeridian: a network straddling
+    +/-180 degrees should shift its longitudes first.
+*/
+class SpatialIndex {
+    struct Point {
+        int id;
+        double latitude, longitude;
+    };
+
+    static constexpr double EARTH_RADIUS_KM = 6371.0;
+    static constexpr double PI = 3.14159265358979323846;
+    static constexpr double RADIANS = PI / 180.0;
+
+    double cellDegrees;
+    std::unordered_map<std::uint64_t, std::vector<Point>> cells;
+    size_t pointCount = 0;
+    // Bounding box of the occupied cells
+    int minRow = 0, maxRow = -1, minCol = 0, maxCol = -1;
+
+    int rowOf(double latitude) const { return static_cast<int>(std::floor(latitude / cellDegrees)); }
+    int colOf(double longitude) const { return static_cast<int>(std::floor(longitude / cellDegrees)); }
+
+    static std::uint64_t keyOf(int row, int col) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(row)) << 32) | static_cast<std::uint32_t>(col);
+    }
+
+    static int rowOfKey(std::uint64_t key) { return static_cast<int>(static_cast<std::uint32_t>(key >> 32)); }
+    static int colOfKey(std::uint64_t key) { return static_cast<int>(static_cast<std::uint32_t>(key)); }
+
+    const std::vector<Point>* cellAt(int row, int col) const {
+        auto it = cells.find(keyOf(row, col));
+        return it != cells.end() ? &it->second : nullptr;
+    }
+
+    /*
+        Lower bound on the distance from (lat, lon) to any point outside the
+        block of cells within Chebyshev distance `ring` of the query cell.
+        Such a point lies beyond one of the block's edges: beyond a latitude
+        edge it is at least the meridian arc away, beyond a longitude edge at
+        least as far as the meridian (a great circle) through that edge.
+    */
+    double outsideBound(double lat, double lon, int row, int col, int ring) const {
+        double latGap = std::min(lat - (row - ring) * cellDegrees, (row + ring + 1) * cellDegrees - lat);
+        double lonGap = std::min(lon - (col - ring) * cellDegrees, (col + ring + 1) * cellDegrees - lon);
+        double latKm = std::max(0.0, latGap) * RADIANS * EARTH_RADIUS_KM;
+        double lonRadians = std::min(90.0, std::max(0.0, lonGap)) * RADIANS;
+        double lonKm = std::asin(std::min(1.0, std::cos(lat * RADIANS) * std::sin(lonRadians))) * EARTH_RADIUS_KM;
+        return std::min(latKm, std::fabs(lonKm));
+    }
+
+    // Chebyshev distance in cells between a cell and the query cell
+    static int ringOf(int row, int col, int queryRow, int queryCol) {
+        return std::max(std::abs(row - queryRow), std::abs(col - queryCol));
+    }
+
+    bool blockCoversAll(int row, int col, int ring) const {
+        return row - ring <= minRow && row + ring >= maxRow && col - ring <= minCol && col + ring >= maxCol;
+    }
+
+    static bool closer(const SpatialNeighbor& a, const SpatialNeighbor& b) {
+        return a.distanceKm != b.distanceKm ? a.distanceKm < b.distanceKm : a.id < b.id;
+    }
+
+    // Keeps the k best candidates as a max-heap on distance (worst on top)
+    static void offer(std::vector<SpatialNeighbor>& best, size_t k, const SpatialNeighbor& candidate) {
+        if (best.size() < k) {
+            best.push_back(candidate);
+            std::push_heap(best.begin(), best.end(), closer);
+        }
+        else if (closer(candidate, best.front())) {
+            std::pop_heap(best.begin(), best.end(), closer);
+            best.back() = candidate;
+            std::push_heap(best.begin(), best.end(), closer);
+        }
+    }
+
+public:
+    // cellDegrees: side of a grid cell; the default (~5.5 km) suits city- to region-sized networks
+    explicit SpatialIndex(double cellDegrees = 0.05) : cellDegrees(cellDegrees > 0 ? cellDegrees : 0.05) {}
+
+    size_t size() const { return pointCount; }
+    bool empty() const { return pointCount == 0; }
+
+    void insert(int id, double latitude, double longitude) {
+        int row = rowOf(latitude);
+        int col = colOf(longitude);
+        cells[keyOf(row, col)].push_back({ id, latitude, longitude });
+        if (pointCount++ == 0) {
+            minRow = maxRow = row;
+            minCol = maxCol = col;
+        }
+        else {
+            minRow = std::min(minRow, row);
+            maxRow = std::max(maxRow, row);
+            minCol = std::min(minCol, col);
+            maxCol = std::max(maxCol, col);
+        }
+    }
+
+    /*
+        The (up to) k points nearest to (latitude, longitude) for which accept(id)
+        holds, nearest first (ties by ID). Points the predicate rejects cost one
+        call each, so keep it cheap. Returns the number of points written.
+    */
+    template <typename Predicate>
+    size_t nearest(double latitude, double longitude, size_t k, Predicate accept,
+        std::vector<SpatialNeighbor>& out) const {
+        out.clear();
+        if (k == 0 || pointCount == 0) return 0;
+
+        int row = rowOf(latitude);
+        int col = colOf(longitude);
+        auto visit = [&](const std::vector<Point>& points) {
+            for (const Point& p : points) {
+                if (!accept(p.id)) continue;
+                offer(out, k, { p.id, greatCircleDistanceKm(latitude, longitude, p.latitude, p.longitude) });
+            }
+        };
+
+        // Rings closer than the bounding box of the data are empty
+        int ring = std::max({ 0, minRow - row, row - maxRow, minCol - col, col - maxCol });
+        for (;; ++ring) {
+            // A ring with more cells than are occupied: finish with one scan of the occupied cells
+            if (8 * static_cast<size_t>(ring) > cells.size()) {
+                for (const auto& cell : cells) {
+                    if (ringOf(rowOfKey(cell.first), colOfKey(cell.first), row, col) >= ring) visit(cell.second);
+                }
+                break;
+            }
+
+            if (ring == 0) {
+                if (const std::vector<Point>* points = cellAt(row, col)) visit(*points);
+            }
+            else {
+                for (int c = col - ring; c <= col + ring; ++c) {
+                    if (const std::vector<Point>* points = cellAt(row - ring, c)) visit(*points);
+                    if (const std::vector<Point>* points = cellAt(row + ring, c)) visit(*points);
+                }
+                for (int r = row - ring + 1; r <= row + ring - 1; ++r) {
+                    if (const std::vector<Point>* points = cellAt(r, col - ring)) visit(*points);
+                    if (const std::vector<Point>* points = cellAt(r, col + ring)) visit(*points);
+                }
+            }
+
+            if (blockCoversAll(row, col, ring)) break;
+            if (out.size() == k && out.front().distanceKm <= outsideBound(latitude, longitude, row, col, ring)) break;
+        }
+
+        std::sort_heap(out.begin(), out.end(), closer);
+        return out.size();
+    }
+
+    // Nearest point for which accept(id) holds, or -1 if there is none
+    template <typename Predicate>
+    int nearest(double latitude, double longitude, Predicate accept, double* distanceKm = nullptr) const {
+        thread_local std::vector<SpatialNeighbor> found;
+        if (nearest(latitude, longitude, 1, accept, found) == 0) return -1;
+        if (distanceKm) *distanceKm = found.front().distanceKm;
+        return found.front().id;
+    }
+
+    // Every point within radiusKm of (latitude, longitude), nearest first. Returns the count.
+    size_t withinRadius(double latitude, double longitude, double radiusKm, std::vector<SpatialNeighbor>& out) const {
+        out.clear();
+        if (pointCount == 0 || radiusKm < 0) return 0;
+
+        // Latitude band of the circle, and the widest longitude span it reaches
+        // (every longitude once the circle contains a pole)
+        double angle = radiusKm / EARTH_RADIUS_KM;
+        double latSpan = angle / RADIANS;
+        int rowLow = std::max(minRow, rowOf(latitude - latSpan));
+        int rowHigh = std::min(maxRow, rowOf(latitude + latSpan));
+        int colLow = minCol, colHigh = maxCol;
+        if (latSpan < 90.0 - std::fabs(latitude)) {
+            double lonSpan = std::asin(std::min(1.0, std::sin(angle) / std::cos(latitude * RADIANS))) / RADIANS;
+            colLow = std::max(minCol, colOf(longitude - lonSpan));
+            colHigh = std::min(maxCol, colOf(longitude + lonSpan));
+        }
+        if (rowLow > rowHigh || colLow > colHigh) return 0;
+
+        auto visit = [&](const std::vector<Point>& points) {
+            for (const Point& p : points) {
+                double d = greatCircleDistanceKm(latitude, longitude, p.latitude, p.longitude);
+                if (d <= radiusKm) out.push_back({ p.id, d });
+            }
+        };
+
+        double boxCells = static_cast<double>(rowHigh - rowLow + 1) * (colHigh - colLow + 1);
+        if (boxCells > static_cast<double>(cells.size())) {
+            for (const auto& cell : cells) {
+                int r = rowOfKey(cell.first), c = colOfKey(cell.first);
+                if (r >= rowLow && r <= rowHigh && c >= colLow && c <= colHigh) visit(cell.second);
+            }
+        }
+        else {
+            for (int r = rowLow; r <= rowHigh; ++r) {
+                for (int c = colLow; c <= colHigh; ++c) {
+                    if (const std::vector<Point>* points = cellAt(r, c)) visit(*points);
+                }
+            }
+        }
+
+        std::sort(out.begin(), out.end(), closer);
+        return out.size();
+    }
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+
+/*
+    Fixed-size pool of worker threads fed from one shared task queue.
+    parallelFor() splits an index range into tasks and blocks until all of
+    them ran, which is all the simulation needs for fan-out/fan-in work.
+*/
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool stopping = false;
+
+    void workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+public:
+    // 0 threads means one per hardware core
+    explicit ThreadPool(size_t threadCount = 0) {
+        if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push(std::move(task));
+        }
+        wakeUp.notify_one();
+    }
+
+    /*
+        Calls fn(i) for every i in [0, count) on the pool and waits for all of them.
+        Indices are handed out in small chunks so uneven work still balances.
+    */
+    template <typename Fn>
+    void parallelFor(size_t count, Fn fn) {
+        if (count == 0) return;
+        size_t chunk = std::max<size_t>(1, count / (workers.size() * 4));
+        size_t taskCount = (count + chunk - 1) / chunk;
+
+        // Counted down and signalled under doneMutex, so the waiter cannot see zero
+        // and destroy these while the last task still uses them
+        size_t remaining = taskCount;
+        std::mutex doneMutex;
+        std::condition_variable done;
+
+        for (size_t begin = 0; begin < count; begin += chunk) {
+            size_t end = std::min(count, begin + chunk);
+            submit([&, begin, end] {
+                for (size_t i = begin; i < end; ++i) fn(i);
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (--remaining == 0) done.notify_one();
+            });
+        }
+
+        std::unique_lock<std::mutex> lock(doneMutex);
+        done.wait(lock, [&] { return remaining == 0; });
+    }
+};
@@ -0,0 +1,113 @@
+// DSA concept used = Timing wheel (calendar queue) with an overflow min-heap
+
+#pragma once
+#include <vector>
+#include <queue>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Simulated time, in scheduler ticks (see ShipmentScheduler for what a tick is)
+using SimTick = std::int64_t;
+
+/*
+    Event queue for discrete-event simulation. The wheel has one slot per tick
+    for the next `slots` ticks (a power of two); an event due in that window is
+    appended to its slot in O(1), and advancing the clock empties the slots in
+    order. Events further out wait in a min-heap and move onto the wheel once
+    the window reaches them, so far-future events cost O(log n) once.
+
+    Events due at the same tick fire in the order they were scheduled, and an
+    event may schedule new ones (even for the tick being processed) from its
+    callback. Not thread-safe.
+*/
+template <typename T>
+class TimingWheel {
+    struct Entry {
+        SimTick due;
+        std::uint64_t sequence;   // scheduling order, breaks ties in the overflow heap
+        T value;
+    };
+    struct LaterFirst {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+        }
+    };
+
+    std::vector<std::vector<Entry>> wheel;
+    SimTick mask;
+    SimTick current = 0;          // first tick that has not fired yet
+    size_t onWheel = 0;
+    std::uint64_t nextSequence = 0;
+    std::priority_queue<Entry, std::vector<Entry>, LaterFirst> overflow;
+
+    bool inWindow(SimTick due) const { return due - current <= mask; }
+
+    // Moves the overflow events that now fall inside the window onto the wheel
+    void pullOverflow() {
+        while (!overflow.empty() && inWindow(overflow.top().due)) {
+            Entry e = overflow.top();
+            overflow.pop();
+            wheel[static_cast<size_t>(e.due & mask)].push_back(std::move(e));
+            ++onWheel;
+        }
+    }
+
+public:
+    explicit TimingWheel(size_t slots = 4096, SimTick start = 0) : current(start) {
+        size_t size = 2;
+        while (size < slots) size <<= 1;
+        wheel.resize(size);
+        mask = static_cast<SimTick>(size) - 1;
+    }
+
+    // First tick that has not been processed; events cannot be scheduled before it
+    SimTick now() const { return current; }
+
+    size_t size() const { return onWheel + overflow.size(); }
+    bool empty() const { return size() == 0; }
+
+    // Schedules `value` for tick `due`; a tick in the past means now()
+    void schedule(SimTick due, T value) {
+        if (due < current) due = current;
+        Entry e{ due, nextSequence++, std::move(value) };
+        if (inWindow(due)) {
+            pullOverflow();   // earlier events for the same tick may still be waiting there
+            wheel[static_cast<size_t>(due & mask)].push_back(std::move(e));
+            ++onWheel;
+        }
+        else {
+            overflow.push(std::move(e));
+        }
+    }
+
+    /*
+        Fires every event due up to and including tick `until`, in tick order,
+        as fire(tick, value). Ticks without events are skipped in bulk while
+        the wheel is empty. Returns the number of events fired.
+    */
+    template <typename Fire>
+    size_t advanceTo(SimTick until, Fire&& fire) {
+        size_t fired = 0;
+        while (current <= until) {
+            if (onWheel == 0) {
+                if (overflow.empty() || overflow.top().due > until) break;
+                current = overflow.top().due;   // nothing is due before the next far event
+            }
+            pullOverflow();
+
+            std::vector<Entry>& slot = wheel[static_cast<size_t>(current & mask)];
+            // Index loop: a callback may append to this slot
+            for (size_t i = 0; i < slot.size(); ++i) {
+                T value = std::move(slot[i].value);
+                --onWheel;
+                ++fired;
+                fire(current, value);
+            }
+            slot.clear();
+            ++current;
+        }
+        if (current <= until) current = until + 1;
+        return fired;
+    }
+};
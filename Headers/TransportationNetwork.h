@@ -1,9 +1,20 @@
 #pragma once
 #include "Location.h"
+#include "SearchWorkspace.h"
+#include "RouteCache.h"
+#include "AStarRouting.h"
+#include "PathQueries.h"
+#include "NetworkSnapshot.h"
+#include "SpatialIndex.h"
+#include "EventJournal.h"
 #include <vector>
+#include <memory>
+#include <random>
 #include <unordered_map>
-#include <queue>
 #include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
 using namespace std;
 
 /*
@@ -12,6 +23,76 @@ using namespace std;
     Edges represent Routes between these Locations.
 */
 
+// Route types ("road", "air", "rail", ...) are interned into a one-byte id,
+// so an edge does not carry its own std::string around.
+using RouteTypeId = std::uint8_t;
+
+class RouteTypeTable {
+    std::vector<std::string> names;                      // id -> name
+    std::unordered_map<std::string, RouteTypeId> ids;    // name -> id
+
+public:
+    RouteTypeTable() { intern("road"); }                 // "road" is always id 0 (the default)
+
+    // Returns the id for a route type name, registering it on first use
+    RouteTypeId intern(const std::string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        if (names.size() > UINT8_MAX) throw std::runtime_error("Too many route types");
+        RouteTypeId id = static_cast<RouteTypeId>(names.size());
+        names.push_back(name);
+        ids.emplace(name, id);
+        return id;
+    }
+
+    const std::string& name(RouteTypeId id) const {
+        static const std::string unknown = "unknown";
+        return id < names.size() ? names[id] : unknown;
+    }
+
+    size_t size() const { return names.size(); }
+};
+
+// A route returned by TransportationNetwork::findKShortestPaths
+struct RouteOption {
+    std::vector<int> path;   // location IDs, source first
+    long long cost = 0;      // sum of route costs
+    int bottleneck = 0;      // most extra load every route on the path can still take
+};
+
+/*
+    Load held on a route by TransportationNetwork::reserveRoute. `edges` are
+    direct CSR edge handles, so releasing the load touches exactly these edges
+    without looking anything up. Handles stay valid until new routes are added;
+    after that the network resolves them again from `path`. A shipment in
+    transit gives its route back one edge at a time (releaseNextHop).
+*/
+struct RouteReservation {
+    std::vector<int> edges;      // edges[i] leads from path[i] to path[i + 1]
+    std::vector<int> path;       // location IDs, source first
+    int load = 0;
+    size_t released = 0;         // leading edges whose load was already taken off
+    std::uint64_t layout = 0;    // TransportationNetwork::layoutVersion() the handles belong to
+    bool held = false;
+};
+
+// One route for TransportationNetwork::addRoutes (bulk loading)
+struct RouteSpec {
+    int from;
+    int to;
+    int capacity;
+    int cost;
+    bool operational = true;
+    double distance = 1.0;
+    RouteTypeId routeType = 0;   // see TransportationNetwork::routeTypeId
+    int load = -1;               // current load in both directions; < 0 draws it like addEdge
+};
+
+/*
+    A single route as seen by callers. The network does not store Edge objects;
+    it keeps its edges in struct-of-arrays form (see CsrGraph) and builds an Edge
+    value on demand when someone iterates getEdges().
+*/
 struct Edge {
     int to;                  // Target location/node ID this edge connects to
     int capacity;            // Max load (e.g., number of supplies or people) that this route can carry
@@ -19,14 +100,14 @@ struct Edge {
     int cost;                // Cost to use this edge (e.g., fuel, effort, or risk score)
     bool isOperational;      // Whether this route is currently usable (true = open, false = blocked)
     double distance;         // Physical or weighted distance between locations
-    std::string routeType;   // Type of route (e.g., "road", "air", "rail")
+    RouteTypeId routeType;   // Interned type of route (see TransportationNetwork::routeTypeName)
 
     /*
         Constructor to initialize all edge properties.
         `currentLoad` starts at 0 and increases as load is added.
     */
     Edge(int to, int capacity, int cost, bool operational, double dist = 1.0,
-        const std::string& type = "road")
+        RouteTypeId type = 0)
         : to(to),
         capacity(capacity),
         currentLoad(0),
@@ -65,111 +146,773 @@ struct Edge {
     }
 };
 
+/*
+    DSA concept used = Compressed Sparse Row (CSR) graph
+
+    Every location that appears in a route gets a dense index 0..N-1. The outgoing
+    edges of node u are stored contiguously in [rowStart[u], rowStart[u + 1]) of
+    each column, so relaxing the neighbours of a node is a linear walk over a few
+    flat arrays instead of a hash lookup plus a vector of fat Edge records.
+    Routes are always added in both directions, so every edge has a `twin` going
+    the other way; the twins of a node's outgoing edges are its incoming edges.
+*/
+struct CsrGraph {
+    std::vector<int> rowStart;                 // size N + 1, offsets into the edge columns
+    std::vector<int> to;                       // dense index of the target node
+    std::vector<int> cost;
+    std::vector<int> capacity;
+    std::vector<int> currentLoad;
+    std::vector<double> distance;
+    std::vector<RouteTypeId> routeType;
+    std::vector<std::uint64_t> operationalBits; // one bit per edge
+    std::vector<int> twin;                     // index of the reverse edge
+    std::vector<std::uint8_t> nodeOpen;        // per node: 0 while the location is offline
+
+    int nodeCount() const { return rowStart.empty() ? 0 : static_cast<int>(rowStart.size()) - 1; }
+    int edgeCount() const { return static_cast<int>(to.size()); }
+
+    bool isOperational(int e) const { return (operationalBits[e >> 6] >> (e & 63)) & 1u; }
+
+    void setOperational(int e, bool operational) {
+        std::uint64_t mask = std::uint64_t(1) << (e & 63);
+        if (operational) operationalBits[e >> 6] |= mask;
+        else operationalBits[e >> 6] &= ~mask;
+    }
+
+    // Same rule as Edge::canAddLoad, evaluated directly on the columns.
+    // Routes into an offline location cannot be used either.
+    bool canAddLoad(int e, int additionalLoad) const {
+        return isOperational(e) && nodeOpen[to[e]] && currentLoad[e] + additionalLoad <= capacity[e];
+    }
+
+    // Largest extra load the edge can take right now, INT_MIN if it is unusable
+    int loadLimit(int e) const {
+        return isOperational(e) && nodeOpen[to[e]] ? capacity[e] - currentLoad[e] : INT_MIN;
+    }
+
+    void reserve(size_t nodes, size_t edges) {
+        rowStart.reserve(nodes + 1);
+        to.reserve(edges);
+        cost.reserve(edges);
+        capacity.reserve(edges);
+        currentLoad.reserve(edges);
+        distance.reserve(edges);
+        routeType.reserve(edges);
+        operationalBits.reserve((edges + 63) / 64);
+        twin.reserve(edges);
+        nodeOpen.reserve(nodes);
+    }
+
+    // Appends an edge at the end of the columns (the caller keeps rows contiguous)
+    void appendEdge(int target, const Edge& e) {
+        int index = edgeCount();
+        to.push_back(target);
+        cost.push_back(e.cost);
+        capacity.push_back(e.capacity);
+        currentLoad.push_back(e.currentLoad);
+        distance.push_back(e.distance);
+        routeType.push_back(e.routeType);
+        twin.push_back(-1);
+        if ((index & 63) == 0) operationalBits.push_back(0);
+        setOperational(index, e.isOperational);
+    }
+};
+
+class NetworkImage;
+
 class TransportationNetwork {
-    std::unordered_map<int, std::vector<Edge>> adjList;
+    friend class NetworkImage;   // writes the CSR columns out and adopts them back (see NetworkImage.h)
+
+    // Edges added after the last freeze, stored with dense source/target indices
+    struct PendingEdge {
+        int from;
+        int to;
+        Edge edge;
+    };
+
+    std::unordered_map<int, int> nodeIndex;    // location ID -> dense node index
+    std::vector<int> nodeIds;                  // dense node index -> location ID
+    RouteTypeTable routeTypes;
+
+    // The CSR arrays are rebuilt lazily (from const queries too) whenever new
+    // edges were added since the last freeze.
+    mutable CsrGraph csr;
+    mutable std::vector<PendingEdge> pendingEdges;
+
+    // Shortest-path trees from frequently used sources (see findCachedPath)
+    mutable RouteCache routeCache;
+
+    // A* lower bounds per metric, rebuilt lazily after routes or locations change
+    mutable RoutingHeuristics heuristics[2];
+    mutable bool heuristicsReady[2] = { false, false };
+    int landmarkCount = 0;
+
     std::unordered_map<int, Location> locations;
+    // Locations bucketed by latitude/longitude for nearest and radius queries
+    SpatialIndex spatialIndex;
+
+    // Draws the initial load of new routes; see seedRandom()
+    std::mt19937 loadRng{ std::random_device{}() };
+
+    // Bumped on every change that can alter a route (see version())
+    std::uint64_t changeVersion = 0;
+    // Receives every route load change when set (see recordLoadChanges)
+    EventJournalWriter* loadJournal = nullptr;
+    // Bumped whenever the CSR edge indices are rebuilt (see layoutVersion())
+    mutable std::uint64_t layoutCounter = 0;
+
+    // Last snapshot handed out (see snapshot()); read and replaced atomically
+    mutable std::shared_ptr<const NetworkSnapshot> published;
+    // Edge state chunks / node status changed since `published` was built
+    mutable std::vector<std::uint8_t> chunkDirty;
+    mutable std::vector<int> dirtyChunks;
+    mutable bool nodeOpenDirty = false;
+
+    int internNode(int id) {
+        auto it = nodeIndex.find(id);
+        if (it != nodeIndex.end()) return it->second;
+        int index = static_cast<int>(nodeIds.size());
+        nodeIndex.emplace(id, index);
+        nodeIds.push_back(id);
+        return index;
+    }
+
+    void ensureFrozen() const {
+        if (pendingEdges.empty() && csr.nodeCount() == static_cast<int>(nodeIds.size())) return;
+        freeze();
+    }
+
+    /*
+        Merges the pending edges into the CSR arrays with one counting pass.
+        Edges keep their insertion order within a row, so getEdges() lists routes
+        in the same order they were added.
+    */
+    void freeze() const {
+        int n = static_cast<int>(nodeIds.size());
+        int oldNodes = csr.nodeCount();
+
+        // Bucket the pending edges per source in insertion order
+        std::vector<int> pendingStart(n + 1, 0);
+        for (const PendingEdge& p : pendingEdges) ++pendingStart[p.from + 1];
+        for (int u = 0; u < n; ++u) pendingStart[u + 1] += pendingStart[u];
+        std::vector<int> pendingOrder(pendingEdges.size());
+        {
+            std::vector<int> fill(pendingStart.begin(), pendingStart.end() - 1);
+            for (int i = 0; i < static_cast<int>(pendingEdges.size()); ++i)
+                pendingOrder[fill[pendingEdges[i].from]++] = i;
+        }
+
+        CsrGraph next;
+        next.reserve(n, csr.edgeCount() + pendingEdges.size());
+        next.rowStart.push_back(0);
+        std::vector<int> movedOld(csr.edgeCount());         // old edge index -> new index
+        std::vector<int> movedPending(pendingEdges.size()); // pending edge -> new index
+        for (int u = 0; u < n; ++u) {
+            if (u < oldNodes) {
+                for (int e = csr.rowStart[u]; e < csr.rowStart[u + 1]; ++e) {
+                    movedOld[e] = next.edgeCount();
+                    next.appendEdge(csr.to[e], edgeAt(e));
+                }
+                next.nodeOpen.push_back(csr.nodeOpen[u]);
+            }
+            else {
+                auto loc = locations.find(nodeIds[u]);
+                next.nodeOpen.push_back(loc == locations.end() || loc->second.isOperational);
+            }
+            for (int k = pendingStart[u]; k < pendingStart[u + 1]; ++k) {
+                const PendingEdge& p = pendingEdges[pendingOrder[k]];
+                movedPending[pendingOrder[k]] = next.edgeCount();
+                next.appendEdge(p.to, p.edge);
+            }
+            next.rowStart.push_back(next.edgeCount());
+        }
+
+        // addEdge stages each route as a (forward, reverse) pair
+        for (int e = 0; e < csr.edgeCount(); ++e) next.twin[movedOld[e]] = movedOld[csr.twin[e]];
+        for (size_t i = 0; i < pendingEdges.size(); ++i) next.twin[movedPending[i]] = movedPending[i ^ 1];
+
+        csr = std::move(next);
+        pendingEdges.clear();
+        pendingEdges.shrink_to_fit();
+        layoutChanged();
+    }
+
+    // Drops everything that refers to edge indices of the previous CSR layout
+    void layoutChanged() const {
+        routeCache.clear();   // edge indices changed
+        ++layoutCounter;
+        // The next snapshot gets a new topology and fresh chunks anyway
+        chunkDirty.assign((csr.edgeCount() + EdgeStateChunk::SIZE - 1) >> EdgeStateChunk::SHIFT, 0);
+        dirtyChunks.clear();
+        nodeOpenDirty = false;
+        heuristicsReady[0] = heuristicsReady[1] = false;
+    }
+
+    // Records that edge e differs from the last published snapshot
+    void markDirty(int e) {
+        int chunk = e >> EdgeStateChunk::SHIFT;
+        if (chunkDirty[chunk]) return;
+        chunkDirty[chunk] = 1;
+        dirtyChunks.push_back(chunk);
+    }
+
+    std::shared_ptr<const EdgeStateChunk> buildChunk(int chunk) const {
+        std::shared_ptr<EdgeStateChunk> c = std::make_shared<EdgeStateChunk>();
+        int first = chunk << EdgeStateChunk::SHIFT;
+        int last = std::min(csr.edgeCount(), first + EdgeStateChunk::SIZE);
+        for (int e = first; e < last; ++e) {
+            c->currentLoad[e - first] = csr.currentLoad[e];
+            c->limit[e - first] = csr.loadLimit(e);
+        }
+        return c;
+    }
+
+    // Dense index of the first edge from -> to, or -1
+    int findEdgeIndex(int fromIndex, int toIndex) const {
+        for (int e = csr.rowStart[fromIndex]; e < csr.rowStart[fromIndex + 1]; ++e) {
+            if (csr.to[e] == toIndex) return e;
+        }
+        return -1;
+    }
+
+    void setEdgeOperational(int fromIndex, int e, bool operational) {
+        if (e < 0 || csr.isOperational(e) == operational) return;
+        int oldLimit = csr.loadLimit(e);
+        csr.setOperational(e, operational);
+        ++changeVersion;
+        markDirty(e);
+        routeCache.onEdgeChanged(csr, fromIndex, e, oldLimit);
+    }
+
+    // Opens or closes a location for routing; every route into it changes usability
+    void setNodeOpen(int v, bool open) {
+        if (static_cast<bool>(csr.nodeOpen[v]) == open) return;
+        csr.nodeOpen[v] = open;
+        ++changeVersion;
+        nodeOpenDirty = true;
+        for (int e = csr.rowStart[v]; e < csr.rowStart[v + 1]; ++e) {
+            int incoming = csr.twin[e];
+            markDirty(incoming);
+            int oldLimit = csr.isOperational(incoming) && !open
+                ? csr.capacity[incoming] - csr.currentLoad[incoming]
+                : INT_MIN;
+            routeCache.onEdgeChanged(csr, csr.to[e], incoming, oldLimit);
+        }
+    }
+
+    const RoutingHeuristics& heuristicsFor(RouteMetric metric) const {
+        int slot = static_cast<int>(metric);
+        if (!heuristicsReady[slot]) {
+            heuristics[slot].build(csr, metric, [this](int v, double& lat, double& lon) {
+                auto it = locations.find(nodeIds[v]);
+                if (it == locations.end()) return false;
+                lat = it->second.latitude;
+                lon = it->second.longitude;
+                return true;
+            });
+            heuristics[slot].selectLandmarks(csr, landmarkCount);
+            heuristicsReady[slot] = true;
+        }
+        return heuristics[slot];
+    }
+
+    // Adds `delta` (may be negative) to the load of edge e and tells the route cache
+    void changeLoad(int e, int delta) {
+        int oldLimit = csr.loadLimit(e);
+        int oldLoad = csr.currentLoad[e];
+        csr.currentLoad[e] = std::max(0, oldLoad + delta);
+        if (loadJournal) loadJournal->edgeLoad(nodeIds[csr.to[csr.twin[e]]], nodeIds[csr.to[e]], csr.currentLoad[e] - oldLoad);
+        ++changeVersion;
+        markDirty(e);
+        routeCache.onEdgeChanged(csr, csr.to[csr.twin[e]], e, oldLimit);
+    }
+
+    // Re-derives the edge handles of a reservation made before the CSR was rebuilt
+    bool resolveEdges(RouteReservation& r) const {
+        ensureFrozen();
+        if (r.layout == layoutCounter) return true;
+        for (size_t i = 0; i + 1 < r.path.size(); ++i) {
+            int fromIndex = indexOf(r.path[i]);
+            int toIndex = indexOf(r.path[i + 1]);
+            r.edges[i] = fromIndex >= 0 && toIndex >= 0 ? findEdgeIndex(fromIndex, toIndex) : -1;
+            if (r.edges[i] < 0) return false;
+        }
+        r.layout = layoutCounter;
+        return true;
+    }
+
+    // Stages both directions of a route for the next freeze
+    void stageRoute(const RouteSpec& r) {
+        int fromIndex = internNode(r.from);
+        int toIndex = internNode(r.to);
+
+        pendingEdges.push_back({ fromIndex, toIndex, Edge(r.to, r.capacity, r.cost, r.operational, r.distance, r.routeType) });
+        // Add reverse direction for bidirectional routes (with possibly different parameters)
+        pendingEdges.push_back({ toIndex, fromIndex, Edge(r.from, r.capacity, r.cost, r.operational, r.distance, r.routeType) });
+        if (r.load >= 0) {
+            pendingEdges[pendingEdges.size() - 2].edge.currentLoad = r.load;
+            pendingEdges[pendingEdges.size() - 1].edge.currentLoad = r.load;
+            return;
+        }
+        // Existing traffic: 20-69% of capacity
+        std::uniform_int_distribution<int> initialLoad(20, 69);
+        pendingEdges[pendingEdges.size() - 2].edge.currentLoad = r.capacity * initialLoad(loadRng) / 100.0;
+        pendingEdges[pendingEdges.size() - 1].edge.currentLoad = r.capacity * initialLoad(loadRng) / 100.0;
+    }
+
+    Edge edgeAt(int e) const {
+        Edge edge(nodeIds[csr.to[e]], csr.capacity[e], csr.cost[e], csr.isOperational(e),
+            csr.distance[e], csr.routeType[e]);
+        edge.currentLoad = csr.currentLoad[e];
+        return edge;
+    }
 
 public:
+    /*
+        Read-only range over the outgoing routes of one location. Iterating it
+        yields Edge values assembled from the CSR columns.
+    */
+    class EdgeRange {
+        const TransportationNetwork* net;
+        int first, last;
+
+    public:
+        class iterator {
+            const TransportationNetwork* net;
+            int e;
+        public:
+            iterator(const TransportationNetwork* net, int e) : net(net), e(e) {}
+            Edge operator*() const { return net->edgeAt(e); }
+            iterator& operator++() { ++e; return *this; }
+            bool operator!=(const iterator& other) const { return e != other.e; }
+            bool operator==(const iterator& other) const { return e == other.e; }
+        };
+
+        EdgeRange(const TransportationNetwork* net, int first, int last) : net(net), first(first), last(last) {}
+        iterator begin() const { return iterator(net, first); }
+        iterator end() const { return iterator(net, last); }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
     void addEdge(int from, int to, int capacity, int cost, bool operational = true,
         double distance = 1.0, const std::string& routeType = "road") {
+        ++changeVersion;
+        stageRoute({ from, to, capacity, cost, operational, distance, routeTypes.intern(routeType), -1 });
+    }
 
-        adjList[from].emplace_back(to, capacity, cost, operational, distance, routeType);
-        // Add reverse direction for bidirectional routes (with possibly different parameters)
-        adjList[to].emplace_back(from, capacity, cost, operational, distance, routeType);
-        adjList[from].back().currentLoad = capacity * (20 + rand() % 50) / 100.0;
-        adjList[to].back().currentLoad = capacity * (20 + rand() % 50) / 100.0;
+    /*
+        Bulk version of addEdge for importers: stages a whole batch of routes in
+        one go. Nothing is rebuilt per route; the CSR arrays are assembled in one
+        counting pass when the network is next queried. Call reserve() first
+        when the total is known to avoid regrowing the staging buffers.
+    */
+    template <typename InputIt>
+    void addRoutes(InputIt first, InputIt last) {
+        if (first == last) return;
+        ++changeVersion;
+        for (; first != last; ++first) stageRoute(*first);
     }
+
+    template <typename Range>
+    void addRoutes(const Range& routes) { addRoutes(std::begin(routes), std::end(routes)); }
+
+    // Pre-sizes the location table and route staging for that many more locations and routes
+    void reserve(size_t locationCount, size_t routeCount) {
+        locations.reserve(locations.size() + locationCount);
+        nodeIndex.reserve(nodeIndex.size() + locationCount);
+        nodeIds.reserve(nodeIds.size() + locationCount);
+        pendingEdges.reserve(pendingEdges.size() + 2 * routeCount);
+    }
+
+    // Id of a route type name for RouteSpec, registering it on first use
+    RouteTypeId routeTypeId(const std::string& name) { return routeTypes.intern(name); }
+
+    // Makes the initial route loads drawn by addEdge reproducible
+    void seedRandom(std::uint32_t seed) { loadRng.seed(seed); }
+
+    /*
+        Journals every route load change from now on (reservations, releases,
+        addLoadToEdge) as an EDGE_LOAD record with the change applied; null
+        stops it. The journal must outlive the network or be detached first.
+    */
+    void recordLoadChanges(EventJournalWriter* journal) { loadJournal = journal; }
     const auto& getLocations() const { return locations; } // Add this accessor
-    const std::vector<Edge>& getEdges(int node) const {
-        static const std::vector<Edge> empty;
-        auto it = adjList.find(node);
-        return it != adjList.end() ? it->second : empty;
+    EdgeRange getEdges(int node) const {
+        auto it = nodeIndex.find(node);
+        if (it == nodeIndex.end()) return EdgeRange(this, 0, 0);
+        ensureFrozen();
+        return EdgeRange(this, csr.rowStart[it->second], csr.rowStart[it->second + 1]);
     }
 
+    // Number of locations that appear in at least one route, and number of directed routes
+    int nodeCount() const { return static_cast<int>(nodeIds.size()); }
+    int edgeCount() const { ensureFrozen(); return csr.edgeCount(); }
+
+    // Dense node index of a location ID (-1 if it has no routes) and back
+    int indexOf(int id) const {
+        auto it = nodeIndex.find(id);
+        return it != nodeIndex.end() ? it->second : -1;
+    }
+    int idAt(int index) const { return nodeIds[index]; }
+
+    // Frozen CSR view of the routes, for algorithms that work on dense indices
+    const CsrGraph& graph() const { ensureFrozen(); return csr; }
+
+    const std::string& routeTypeName(RouteTypeId id) const { return routeTypes.name(id); }
+
+    // Changes whenever a route or location status, or a route load, changes.
+    // Lets batch routers detect that routes computed earlier may be stale.
+    std::uint64_t version() const { return changeVersion; }
+
     void updateEdgeStatus(int from, int to, bool operational) {
+        int fromIndex = indexOf(from);
+        int toIndex = indexOf(to);
+        if (fromIndex < 0 || toIndex < 0) return;
+        ensureFrozen();
+
         // Update edge from -> to
-        auto itFrom = adjList.find(from);
-        if (itFrom != adjList.end()) {
-            for (auto& edge : itFrom->second) {
-                if (edge.to == to) {
-                    edge.isOperational = operational;
-                    break;
-                }
-            }
-        }
+        setEdgeOperational(fromIndex, findEdgeIndex(fromIndex, toIndex), operational);
         // Update edge to -> from
-        auto itTo = adjList.find(to);
-        if (itTo != adjList.end()) {
-            for (auto& edge : itTo->second) {
-                if (edge.to == from) {
-                    edge.isOperational = operational;
-                    break;
-                }
-            }
-        }
+        setEdgeOperational(toIndex, findEdgeIndex(toIndex, fromIndex), operational);
     }
     void addLoadToEdge(int from, int to, int load) {
-        auto it = adjList.find(from);
-        if (it != adjList.end()) {
-            for (auto& edge : it->second) {
-                if (edge.to == to) {
-                    edge.addLoad(load);
-                    break;
-                }
+        int fromIndex = indexOf(from);
+        int toIndex = indexOf(to);
+        if (fromIndex < 0 || toIndex < 0) return;
+        ensureFrozen();
+
+        int e = findEdgeIndex(fromIndex, toIndex);
+        if (e >= 0 && csr.canAddLoad(e, load)) changeLoad(e, load);
+    }
+
+    /*
+        Immutable snapshot of the current routes, loads and statuses (see
+        NetworkSnapshot). Repeated calls without changes in between return the
+        same object. Otherwise a new version is built copy-on-write: it shares
+        the topology and every edge chunk that was not touched since the
+        previous snapshot, so the cost is proportional to what changed.
+
+        Call this from the thread that modifies the network; the snapshot it
+        returns may then be read from any thread, for as long as the reader
+        holds it, while the network goes on changing.
+    */
+    std::shared_ptr<const NetworkSnapshot> snapshot() const {
+        ensureFrozen();
+        std::shared_ptr<const NetworkSnapshot> last = std::atomic_load(&published);
+        bool sameLayout = last && last->layoutVersion() == layoutCounter;
+        if (sameLayout && last->version() == changeVersion) return last;
+
+        std::shared_ptr<const SnapshotTopology> topology;
+        std::vector<std::shared_ptr<const EdgeStateChunk>> chunks(chunkDirty.size());
+        std::shared_ptr<const std::vector<std::uint8_t>> open;
+        if (sameLayout) {
+            topology = last->sharedTopology();
+            for (size_t i = 0; i < chunks.size(); ++i) {
+                chunks[i] = chunkDirty[i] ? buildChunk(static_cast<int>(i)) : last->sharedChunk(i);
             }
+            open = nodeOpenDirty ? std::make_shared<const std::vector<std::uint8_t>>(csr.nodeOpen)
+                : last->sharedNodeOpen();
         }
+        else {
+            std::shared_ptr<SnapshotTopology> t = std::make_shared<SnapshotTopology>();
+            t->rowStart = csr.rowStart;
+            t->to = csr.to;
+            t->cost = csr.cost;
+            t->capacity = csr.capacity;
+            t->nodeIds = nodeIds;
+            t->nodeIndex = nodeIndex;
+            t->layout = layoutCounter;
+            topology = std::move(t);
+            for (size_t i = 0; i < chunks.size(); ++i) chunks[i] = buildChunk(static_cast<int>(i));
+            open = std::make_shared<const std::vector<std::uint8_t>>(csr.nodeOpen);
+        }
+
+        for (int chunk : dirtyChunks) chunkDirty[chunk] = 0;
+        dirtyChunks.clear();
+        nodeOpenDirty = false;
+
+        std::shared_ptr<const NetworkSnapshot> next = std::make_shared<const NetworkSnapshot>(
+            std::move(topology), std::move(chunks), std::move(open), changeVersion);
+        std::atomic_store(&published, next);
+        return next;
     }
-    std::vector<int> findOptimalPath(int source, int destination, int requiredCapacity = 1) const {
-        if (adjList.find(source) == adjList.end() || adjList.find(destination) == adjList.end())
-            return {};  // Invalid source or destination
-        std::unordered_map<int, int> dist;
-        std::unordered_map<int, int> prev;
-        typedef std::pair<int, int> pq_node;
-        std::priority_queue<pq_node, std::vector<pq_node>, std::greater<pq_node>> pq;
-
-        for (const auto& node : adjList) dist[node.first] = INT_MAX;
-        dist[source] = 0;
-        pq.emplace(0, source);
-
-        while (!pq.empty()) {
-            pq_node top = pq.top();
-            int currentDist = top.first;
-            int u = top.second;
-            pq.pop();
-
-            if (u == destination) break;
-            if (currentDist > dist[u]) continue;
-
-            auto edgesIt = adjList.find(u);
-            if (edgesIt == adjList.end()) continue;
-
-            for (const Edge& e : edgesIt->second) {
-                if (!e.isOperational || !e.canAddLoad(requiredCapacity)) continue;
-                if (dist.count(e.to) == 0) dist[e.to] = INT_MAX;
-                if (dist[e.to] > dist[u] + e.cost) {
-                    dist[e.to] = dist[u] + e.cost;
-                    prev[e.to] = u;
-                    pq.emplace(dist[e.to], e.to);
-                }
-            }
+
+    /*
+        The most recent snapshot built by snapshot(), or null if none was built
+        yet. Safe to call from any thread at any time, including while the
+        network is being modified; the result may lag behind the live network.
+    */
+    std::shared_ptr<const NetworkSnapshot> latestSnapshot() const {
+        return std::atomic_load(&published);
+    }
+
+    // Changes whenever edge handles (CSR indices) are renumbered, i.e. after routes were added
+    std::uint64_t layoutVersion() const { ensureFrozen(); return layoutCounter; }
+
+    /*
+        Phase one of a transfer: finds the cheapest route that can take `load`
+        and puts the load on all of its edges in the same pass. The reservation
+        keeps the edge handles, so releaseRoute() is O(path length).
+        Returns false (and holds nothing) if no route can carry the load.
+    */
+    bool reserveRoute(int source, int destination, int load, RouteReservation& r) {
+        r.edges.clear();
+        r.path.clear();
+        r.released = 0;
+        r.held = false;
+        int src = indexOf(source);
+        int dst = indexOf(destination);
+        if (src < 0 || dst < 0 || src == dst || load <= 0) return false;
+        ensureFrozen();
+
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        runDijkstra(csr, ws, src, dst, load);
+        if (!ws.reached(dst)) return false;
+
+        for (int at = dst; at != src; at = ws.predecessor(at)) {
+            r.edges.push_back(ws.predecessorEdge(at));
+            r.path.push_back(nodeIds[at]);
         }
+        r.path.push_back(source);
+        std::reverse(r.edges.begin(), r.edges.end());
+        std::reverse(r.path.begin(), r.path.end());
 
-        std::vector<int> path;
-        int at = destination;
-        while (prev.count(at) && at != source) {
-            path.push_back(at);
-            at = prev[at];
+        // The search only used edges that can take the load, so no re-check is needed
+        for (int e : r.edges) changeLoad(e, load);
+        r.load = load;
+        r.layout = layoutCounter;
+        r.held = true;
+        return true;
+    }
+
+    /*
+        Puts `load` on every edge of `edges` (handles from the current layout) if
+        all of them can take it, otherwise changes nothing. One pass to check,
+        one to apply.
+    */
+    bool reserveEdges(const std::vector<int>& edges, int load) {
+        ensureFrozen();
+        for (int e : edges) {
+            if (e < 0 || e >= csr.edgeCount() || !csr.canAddLoad(e, load)) return false;
+        }
+        for (int e : edges) changeLoad(e, load);
+        return true;
+    }
+
+    // Undoes reserveEdges: takes `load` off every edge of `edges` (handles from the current layout)
+    void releaseEdges(const std::vector<int>& edges, int load) {
+        ensureFrozen();
+        for (int e : edges) {
+            if (e >= 0 && e < csr.edgeCount()) changeLoad(e, -load);
+        }
+    }
+
+    // Rolls a reservation back: takes its load off the edges it still holds
+    void releaseRoute(RouteReservation& r) {
+        if (!r.held) return;
+        if (resolveEdges(r)) {
+            for (size_t i = r.released; i < r.edges.size(); ++i) changeLoad(r.edges[i], -r.load);
+        }
+        r.released = r.edges.size();
+        r.held = false;
+    }
+
+    /*
+        Takes the load off the first edge the reservation still holds, once a
+        shipment has passed it. After the last edge the reservation is no
+        longer held. Returns false if nothing was held.
+    */
+    bool releaseNextHop(RouteReservation& r) {
+        if (!r.held || r.released >= r.edges.size()) return false;
+        if (resolveEdges(r) && r.edges[r.released] >= 0) changeLoad(r.edges[r.released], -r.load);
+        if (++r.released == r.edges.size()) r.held = false;
+        return true;
+    }
+
+    // Takes `load` off the route from -> to (never below zero); the counterpart of addLoadToEdge
+    void removeLoadFromEdge(int from, int to, int load) {
+        int fromIndex = indexOf(from);
+        int toIndex = indexOf(to);
+        if (fromIndex < 0 || toIndex < 0 || load <= 0) return;
+        ensureFrozen();
+
+        int e = findEdgeIndex(fromIndex, toIndex);
+        if (e >= 0) changeLoad(e, -load);
+    }
+    /*
+        Cheapest route from source to destination using only edges that can take
+        `requiredCapacity` more load. The path (location IDs, source first) is
+        written into `path`, reusing its buffer; it is left empty if no route exists.
+        Runs on the calling thread's SearchWorkspace, so repeated queries do not allocate.
+    */
+    bool findOptimalPath(int source, int destination, int requiredCapacity, std::vector<int>& path) const {
+        RRP_METRIC_TIMER(timer, PATH_LATENCY);
+        RRP_METRIC_ADD(PATH_QUERIES, 1);
+        path.clear();
+        int src = indexOf(source);
+        int dst = indexOf(destination);
+        if (src < 0 || dst < 0) {
+            RRP_METRIC_ADD(PATH_NOT_FOUND, 1);
+            return false;  // Invalid source or destination
+        }
+        ensureFrozen();
+
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        runDijkstra(csr, ws, src, dst, requiredCapacity);
+        if (!ws.reached(dst)) {
+            RRP_METRIC_ADD(PATH_NOT_FOUND, 1);
+            return false;
         }
-        if (at == source) {
-            path.push_back(source);
-            std::reverse(path.begin(), path.end());
+
+        for (int at = dst; at >= 0; at = ws.predecessor(at)) {
+            path.push_back(nodeIds[at]);
         }
+        std::reverse(path.begin(), path.end());
+        return true;
+    }
+
+    std::vector<int> findOptimalPath(int source, int destination, int requiredCapacity = 1) const {
+        std::vector<int> path;
+        findOptimalPath(source, destination, requiredCapacity, path);
         return path;
     }
 
+    /*
+        Point-to-point route minimising `metric`, found with A*. The search is guided
+        by the straight-line distance between locations and by the landmarks chosen
+        with useLandmarks(), and falls back to plain Dijkstra when neither bound is
+        safe for the metric. Same contract as findOptimalPath otherwise.
+    */
+    bool findOptimalPathAStar(int source, int destination, int requiredCapacity, RouteMetric metric,
+        std::vector<int>& path) const {
+        path.clear();
+        int src = indexOf(source);
+        int dst = indexOf(destination);
+        if (src < 0 || dst < 0) return false;
+        ensureFrozen();
+
+        const RoutingHeuristics& h = heuristicsFor(metric);
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        runAStar(csr, h.edgeWeights(), ws, src, dst, requiredCapacity,
+            [&h, dst](int v) { return h.lowerBound(v, dst); });
+        if (!ws.reached(dst)) return false;
+
+        for (int at = dst; at >= 0; at = ws.predecessor(at)) {
+            path.push_back(nodeIds[at]);
+        }
+        std::reverse(path.begin(), path.end());
+        return true;
+    }
+
+    /*
+        Route whose tightest edge has the most spare capacity, ignoring cost.
+        Writes it into `path` and returns that bottleneck (the largest load one
+        route can carry from source to destination), or 0 with an empty path.
+    */
+    int findWidestPath(int source, int destination, std::vector<int>& path) const {
+        path.clear();
+        int src = indexOf(source);
+        int dst = indexOf(destination);
+        if (src < 0 || dst < 0) return 0;
+        ensureFrozen();
+
+        SearchWorkspace& ws = SearchWorkspace::forThisThread();
+        int width = runWidestPath(csr, ws, src, dst);
+        if (width <= 0) return 0;
+
+        for (int at = dst; at >= 0; at = ws.predecessor(at)) {
+            path.push_back(nodeIds[at]);
+        }
+        std::reverse(path.begin(), path.end());
+        return width;
+    }
+
+    /*
+        Up to `maxRoutes` loopless routes, cheapest first, on which every edge can
+        take `requiredCapacity` more load (Yen's algorithm). Lets a planner see
+        alternatives to spread a shipment over. Returns the number of routes.
+    */
+    int findKShortestPaths(int source, int destination, int requiredCapacity, int maxRoutes,
+        std::vector<RouteOption>& routes) const {
+        routes.clear();
+        int src = indexOf(source);
+        int dst = indexOf(destination);
+        if (src < 0 || dst < 0) return 0;
+        ensureFrozen();
+
+        thread_local std::vector<CandidateRoute> found;
+        yenKShortestPaths(csr, SearchWorkspace::forThisThread(), src, dst, requiredCapacity, maxRoutes, found);
+        routes.resize(found.size());
+        for (size_t i = 0; i < found.size(); ++i) {
+            routes[i].path.clear();
+            for (int v : found[i].nodes) routes[i].path.push_back(nodeIds[v]);
+            routes[i].cost = found[i].cost;
+            routes[i].bottleneck = found[i].bottleneck;
+        }
+        return static_cast<int>(routes.size());
+    }
+
+    // Number of ALT landmarks (picked from the best-connected hubs) used by findOptimalPathAStar
+    void useLandmarks(int count) {
+        landmarkCount = std::max(0, count);
+        heuristicsReady[0] = heuristicsReady[1] = false;
+    }
+
+    /*
+        Shortest-path tree from `source` for loads of `requiredCapacity`, served from
+        the route cache when the same depot was queried before. Returns nullptr for
+        an unknown source. The tree stays valid until the next cached lookup that
+        misses (shortestPathsFrom or findCachedPath, even through const access),
+        or any change to the network. Not thread-safe: the cache is shared by
+        all callers of this network.
+    */
+    const ShortestPathTree* shortestPathsFrom(int source, int requiredCapacity) const {
+        int src = indexOf(source);
+        if (src < 0) return nullptr;
+        ensureFrozen();
+        return &routeCache.lookup(csr, src, requiredCapacity);
+    }
+
+    // Same result as findOptimalPath, but answered by walking a cached shortest-path tree
+    bool findCachedPath(int source, int destination, int requiredCapacity, std::vector<int>& path) const {
+        RRP_METRIC_TIMER(timer, CACHED_PATH_LATENCY);
+        RRP_METRIC_ADD(CACHED_PATH_QUERIES, 1);
+        path.clear();
+        int dst = indexOf(destination);
+        const ShortestPathTree* tree = shortestPathsFrom(source, requiredCapacity);
+        if (!tree || dst < 0 || !tree->reaches(dst)) return false;
+
+        for (int at = dst; at >= 0; at = tree->parent[at]) {
+            path.push_back(nodeIds[at]);
+        }
+        std::reverse(path.begin(), path.end());
+        return true;
+    }
+
     // In the TransportationNetwork class:
+    // A location keeps the coordinates it was added with in the spatial index
     void addLocation(const Location& loc) {
-        locations.emplace(loc.id, loc); // Fixes Location default constructor issue
+        bool added = locations.emplace(loc.id, loc).second; // Fixes Location default constructor issue
+        if (added) spatialIndex.insert(loc.id, loc.latitude, loc.longitude);
+        heuristicsReady[0] = heuristicsReady[1] = false;
+        // A location that already has routes picks up its status right away
+        int v = indexOf(loc.id);
+        if (v >= 0 && v < csr.nodeCount()) setNodeOpen(v, getLocation(loc.id)->isOperational);
+    }
+
+    /*
+        Brings a location online or offline. Offline locations are not routed
+        through, and cached shortest-path trees are repaired in place.
+        Use this instead of Location::updateStatus so routing sees the change.
+    */
+    void updateLocationStatus(int id, bool operational) {
+        Location* loc = getLocation(id);
+        if (loc) loc->updateStatus(operational);
+        int v = indexOf(id);
+        if (v < 0) return;
+        ensureFrozen();
+        setNodeOpen(v, operational);
     }
 
     Location* getLocation(int id) {
@@ -187,6 +930,30 @@ public:
         return it != locations.end() && it->second.isOperational;
     }
 
+    /*
+        The (up to) `count` locations nearest to a point for which accept(const Location&)
+        holds, nearest first. E.g. "the closest operational depot holding 200 units
+        of water". Returns the number written to `out`.
+    */
+    template <typename Predicate>
+    size_t findNearestLocations(double latitude, double longitude, size_t count, Predicate accept,
+        std::vector<SpatialNeighbor>& out) const {
+        return spatialIndex.nearest(latitude, longitude, count,
+            [&](int id) { return accept(locations.find(id)->second); }, out);
+    }
+
+    // Nearest location to a point for which accept(const Location&) holds, or -1
+    template <typename Predicate>
+    int findNearestLocation(double latitude, double longitude, Predicate accept) const {
+        return spatialIndex.nearest(latitude, longitude, [&](int id) { return accept(locations.find(id)->second); });
+    }
+
+    // Every location within radiusKm of a point (e.g. a disaster epicentre), nearest first
+    size_t findLocationsWithinRadius(double latitude, double longitude, double radiusKm,
+        std::vector<SpatialNeighbor>& out) const {
+        return spatialIndex.withinRadius(latitude, longitude, radiusKm, out);
+    }
+
     void printNetworkStatus() const {
         std::cout << "\n========== Network Status ==========\n";
         std::cout << "Locations:\n";
@@ -199,14 +966,15 @@ public:
         }
 
         std::cout << "\nRoutes:\n";
-        for (const auto& node : adjList) {
-            for (const auto& edge : node.second) {
-                std::cout << "  " << node.first << " -> " << edge.to
-                    << " [" << edge.routeType << ", "
-                    << (edge.isOperational ? "Open" : "Closed") << ", "
-                    << edge.currentLoad << "/" << edge.capacity << " capacity, "
-                    << edge.cost << " cost, "
-                    << edge.distance << " distance]\n";
+        ensureFrozen();
+        for (int u = 0; u < csr.nodeCount(); ++u) {
+            for (int e = csr.rowStart[u]; e < csr.rowStart[u + 1]; ++e) {
+                std::cout << "  " << nodeIds[u] << " -> " << nodeIds[csr.to[e]]
+                    << " [" << routeTypes.name(csr.routeType[e]) << ", "
+                    << (csr.isOperational(e) ? "Open" : "Closed") << ", "
+                    << csr.currentLoad[e] << "/" << csr.capacity[e] << " capacity, "
+                    << csr.cost[e] << " cost, "
+                    << csr.distance[e] << " distance]\n";
             }
         }
     }
@@ -1,30 +1,84 @@
- // it tracks when an event happens to log it 
+ // it tracks when an event happens to log it
 #pragma once
 #include <chrono>
-#include <iomanip>
-#include <sstream>
 #include <string>
 #include <ctime>
+#include <cstdint>
+#include <cstring>
 
-inline std::string getCurrentTimestamp() {
-    // gets the current time from real-world
-    auto now = std::chrono::system_clock::now();
-    // type conversion
-    auto time_t_now = std::chrono::system_clock::to_time_t(now);
-    std::tm tm_now;
-    // splitting into year, month, date, hour, min, sec
+/*
+    Event times are stored as raw integers (nanoseconds since the Unix epoch,
+    wall clock) and only turned into text when printed. Taking a timestamp is a
+    single clock read.
+*/
+using Timestamp = std::int64_t;
+
+inline Timestamp nowTimestamp() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Length of YYYY-MM-DDTHH:MM:SS.mmm
+constexpr size_t TIMESTAMP_TEXT_LENGTH = 23;
+
+/*
+    Writes `t` as YYYY-MM-DDTHH:MM:SS.mmm (local time) into out[0..22], no terminator.
+    The date/time part only changes once per second, so each thread keeps the
+    last one it formatted: within the same second formatting is a memcpy plus
+    three millisecond digits, and localtime runs once per second at most.
+*/
+inline void formatTimestampTo(Timestamp t, char* out) {
+    const std::int64_t NS_PER_SECOND = 1000000000;
+    std::int64_t seconds = t / NS_PER_SECOND;
+    std::int64_t subsecond = t % NS_PER_SECOND;
+    if (subsecond < 0) {   // floor for times before the epoch
+        subsecond += NS_PER_SECOND;
+        --seconds;
+    }
+
+    thread_local std::int64_t cachedSecond = INT64_MIN;
+    thread_local char cachedPrefix[20];
+    if (seconds != cachedSecond) {
+        std::time_t time_t_now = static_cast<std::time_t>(seconds);
+        std::tm tm_now;
+        // splitting into year, month, date, hour, min, sec
 #ifdef _WIN32
-    localtime_s(&tm_now, &time_t_now);
+        localtime_s(&tm_now, &time_t_now);
 #else
-    localtime_r(&time_t_now, &tm_now);  // thread-safe
+        localtime_r(&time_t_now, &tm_now);  // thread-safe
 #endif
+        std::strftime(cachedPrefix, sizeof(cachedPrefix), "%Y-%m-%dT%H:%M:%S", &tm_now);
+        cachedSecond = seconds;
+    }
 
-    auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+    int milliseconds = static_cast<int>(subsecond / 1000000);
+    std::memcpy(out, cachedPrefix, 19);
+    out[19] = '.';
+    out[20] = static_cast<char>('0' + milliseconds / 100);
+    out[21] = static_cast<char>('0' + milliseconds / 10 % 10);
+    out[22] = static_cast<char>('0' + milliseconds % 10);
+}
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm_now, "%Y-%m-%dT%H:%M:%S");
-    oss << '.' << std::setw(3) << std::setfill('0') << milliseconds.count();
+// Appends the formatted time to `out` without a temporary string
+inline void appendTimestamp(std::string& out, Timestamp t) {
+    size_t at = out.size();
+    out.resize(at + TIMESTAMP_TEXT_LENGTH);
+    formatTimestampTo(t, &out[at]);
+}
+
+inline std::string formatTimestamp(Timestamp t) {
+    std::string text(TIMESTAMP_TEXT_LENGTH, '0');
+    formatTimestampTo(t, &text[0]);
+    return text;
+}
 
-    return oss.str();
+// Formats a wall-clock time as YYYY-MM-DDTHH:MM:SS.mmm (local time)
+inline std::string formatTimestamp(std::chrono::system_clock::time_point now) {
+    return formatTimestamp(static_cast<Timestamp>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count()));
+}
+
+inline std::string getCurrentTimestamp() {
+    // gets the current time from real-world
+    return formatTimestamp(nowTimestamp());
 }
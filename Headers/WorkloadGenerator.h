@@ -0,0 +1,283 @@
+// DSA concept used = Random graph models (lattice, random geometric graph, clustered road network)
+
+#pragma once
+#include "TransportationNetwork.h"
+#include "ResourceManager.h"
+#include "Request.h"
+#include "SpatialIndex.h"
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+enum class NetworkShape {
+    GRID,               // square lattice of streets, every crossing a location
+    RANDOM_GEOMETRIC,   // uniform points, routes between all pairs closer than a radius
+    ROAD_LIKE           // towns of different sizes with local streets, joined by highways
+};
+
+inline const char* networkShapeName(NetworkShape shape) {
+    switch (shape) {
+    case NetworkShape::GRID: return "grid";
+    case NetworkShape::RANDOM_GEOMETRIC: return "geometric";
+    case NetworkShape::ROAD_LIKE: return "road";
+    }
+    return "unknown";
+}
+
+// Inverse of networkShapeName; false for an unknown name
+inline bool parseNetworkShape(const std::string& name, NetworkShape& out) {
+    for (NetworkShape shape : { NetworkShape::GRID, NetworkShape::RANDOM_GEOMETRIC, NetworkShape::ROAD_LIKE }) {
+        if (name == networkShapeName(shape)) {
+            out = shape;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct WorkloadOptions {
+    NetworkShape shape = NetworkShape::GRID;
+    int locations = 1000;                       // IDs 1..locations; 1 is the central warehouse
+    double averageDegree = 6.0;                 // RANDOM_GEOMETRIC: expected routes per location
+    double regionKm = 50.0;                     // side of the square the locations are spread over
+    double centerLatitude = 34.0522;            // region center (the demo network's warehouse)
+    double centerLongitude = -118.2437;
+    int stockScale = 1;                         // multiplies the initial stock, like SimulationConfig::scale
+    double stockedShare = 0.05;                 // share of field sites that start with local stock
+    std::uint64_t seed = 1;
+};
+
+/*
+    Builds synthetic networks of any size for benchmarks and load tests, with
+    the same resource types, stock shape and request mix as the demo network.
+    The same options always give the same network and requests. Routes get a
+    distance from the great-circle distance of their ends, a cost that grows
+    with it, and the usual random initial load (drawn by the network, see
+    TransportationNetwork::seedRandom).
+*/
+class WorkloadGenerator {
+    static constexpr double KM_PER_DEGREE = 111.195;
+
+    WorkloadOptions options;
+    std::mt19937_64 rng;
+    std::vector<RouteSpec> routes;
+    std::vector<ResourceTypeId> resourceTypes;
+
+    double uniform(double low, double high) { return std::uniform_real_distribution<double>(low, high)(rng); }
+    int uniformInt(int low, int high) { return std::uniform_int_distribution<int>(low, high)(rng); }
+
+    // Local flat projection around the region center: x east, y north, in km
+    double latitudeAt(double yKm) const { return options.centerLatitude + yKm / KM_PER_DEGREE; }
+    double longitudeAt(double xKm) const {
+        return options.centerLongitude + xKm / (KM_PER_DEGREE * std::cos(options.centerLatitude * 3.14159265358979323846 / 180.0));
+    }
+
+    void addLocation(TransportationNetwork& net, int id, double xKm, double yKm, int capacity) {
+        std::string name = id == 1 ? std::string("Central Warehouse") : "Site " + std::to_string(id);
+        net.addLocation(Location(id, name, latitudeAt(yKm), longitudeAt(xKm), true, capacity));
+    }
+
+    void addRoute(const TransportationNetwork& net, int from, int to, int minCapacity, int maxCapacity,
+        double costPerKm, RouteTypeId type) {
+        double km = greatCircleDistanceKm(*net.getLocation(from), *net.getLocation(to));
+        int cost = 1 + static_cast<int>(std::lround(km * costPerKm));
+        routes.push_back({ from, to, uniformInt(minCapacity, maxCapacity), cost, true, km, type, -1 });
+    }
+
+    // Lattice as close to square as the count allows; the warehouse sits in the middle
+    void buildGrid(TransportationNetwork& net) {
+        const int n = options.locations;
+        const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+        const int rows = (n + side - 1) / side;
+        const double spacing = options.regionKm / side;
+        const int center = std::min(n - 1, (rows / 2) * side + side / 2);
+        // Cell k gets ID k + 1, except that the center and cell 0 swap
+        auto idOf = [&](int k) { return k == center ? 1 : k == 0 ? center + 1 : k + 1; };
+
+        for (int k = 0; k < n; ++k) {
+            addLocation(net, idOf(k), (k % side - side / 2) * spacing, (side / 2 - k / side) * spacing, 2000);
+        }
+        RouteTypeId road = net.routeTypeId("road");
+        for (int k = 0; k < n; ++k) {
+            if ((k + 1) % side != 0 && k + 1 < n) addRoute(net, idOf(k), idOf(k + 1), 500, 1500, 2.0, road);
+            if (k + side < n) addRoute(net, idOf(k), idOf(k + side), 500, 1500, 2.0, road);
+        }
+    }
+
+    /*
+        Uniform points joined when closer than the radius that gives the requested
+        average degree. Each point is also joined to its nearest earlier point when
+        no radius route covers it, so the network is always connected.
+    */
+    void buildRandomGeometric(TransportationNetwork& net) {
+        const int n = options.locations;
+        const double half = options.regionKm / 2;
+        addLocation(net, 1, 0, 0, 10000);
+        for (int id = 2; id <= n; ++id) addLocation(net, id, uniform(-half, half), uniform(-half, half), 2000);
+
+        const double radiusKm = options.regionKm * std::sqrt(options.averageDegree / (3.14159265358979323846 * n));
+        RouteTypeId road = net.routeTypeId("road");
+        SpatialIndex earlier;
+        std::vector<SpatialNeighbor> near;
+        for (int id = 1; id <= n; ++id) {
+            const Location& loc = *net.getLocation(id);
+            net.findLocationsWithinRadius(loc.latitude, loc.longitude, radiusKm, near);
+            for (const SpatialNeighbor& other : near) {
+                if (other.id > id) addRoute(net, id, other.id, 500, 1500, 2.0, road);
+            }
+            double distance = 0;
+            int closest = earlier.nearest(loc.latitude, loc.longitude, [](int) { return true; }, &distance);
+            if (closest > 0 && distance > radiusKm) addRoute(net, closest, id, 500, 1500, 2.0, road);
+            earlier.insert(id, loc.latitude, loc.longitude);
+        }
+    }
+
+    /*
+        Towns with Zipf-distributed sizes (the first, holding the warehouse, is the
+        largest). Sites scatter around their town center; each links to the
+        nearest site already placed in its town and sometimes to a second one,
+        which gives the tree-like streets with an average degree below 3 seen in
+        real road graphs. Town centers are joined by highways to their three
+        nearest neighbours and to a town placed before them, so every site is
+        reachable.
+    */
+    void buildRoadLike(TransportationNetwork& net) {
+        const int n = options.locations;
+        const int townCount = std::max(1, n / 250);
+        const double half = options.regionKm / 2;
+
+        std::vector<double> weight(townCount);
+        double weightSum = 0;
+        for (int t = 0; t < townCount; ++t) weightSum += weight[t] = 1.0 / (t + 1);
+        std::vector<double> townX(townCount), townY(townCount);
+        std::vector<int> townHub(townCount);
+        townX[0] = townY[0] = 0;
+        for (int t = 1; t < townCount; ++t) {
+            townX[t] = uniform(-half, half);
+            townY[t] = uniform(-half, half);
+        }
+
+        RouteTypeId road = net.routeTypeId("road");
+        RouteTypeId highway = net.routeTypeId("highway");
+        std::normal_distribution<double> scatter(0.0, 1.0);
+        std::vector<SpatialNeighbor> near;
+        int nextId = 1;
+        for (int t = 0; t < townCount; ++t) {
+            int size = t == townCount - 1 ? n - nextId + 1
+                : std::max(1, static_cast<int>(std::lround(n * weight[t] / weightSum)));
+            size = std::min(size, n - nextId + 1 - (townCount - 1 - t));   // leave one site for every later town
+            const double spreadKm = 0.5 + 2.0 * std::sqrt(size / 250.0);
+
+            SpatialIndex town(0.01);
+            townHub[t] = nextId;
+            for (int i = 0; i < size; ++i, ++nextId) {
+                double x = townX[t], y = townY[t];
+                if (i > 0) {
+                    x += scatter(rng) * spreadKm;
+                    y += scatter(rng) * spreadKm;
+                }
+                addLocation(net, nextId, x, y, nextId == 1 ? 10000 : i == 0 ? 5000 : 1000);
+                const Location& loc = *net.getLocation(nextId);
+                size_t links = uniform(0, 1) < 0.4 ? 2 : 1;
+                town.nearest(loc.latitude, loc.longitude, links, [](int) { return true; }, near);
+                for (const SpatialNeighbor& other : near) addRoute(net, other.id, nextId, 600, 1500, 2.0, road);
+                town.insert(nextId, loc.latitude, loc.longitude);
+            }
+        }
+
+        SpatialIndex hubs(0.05);
+        for (int t = 0; t < townCount; ++t) {
+            const Location& hub = *net.getLocation(townHub[t]);
+            hubs.insert(townHub[t], hub.latitude, hub.longitude);
+        }
+        // Each hub to its three nearest hubs (the query includes the hub itself) and,
+        // to keep all towns connected, to the nearest hub of an earlier town; each pair once
+        std::vector<std::pair<int, int>> highways;
+        SpatialIndex earlierHubs(0.05);
+        for (int t = 0; t < townCount; ++t) {
+            const Location& hub = *net.getLocation(townHub[t]);
+            hubs.nearest(hub.latitude, hub.longitude, 4, [](int) { return true; }, near);
+            for (const SpatialNeighbor& other : near) {
+                if (other.id != townHub[t]) highways.emplace_back(std::min(other.id, townHub[t]), std::max(other.id, townHub[t]));
+            }
+            int closest = earlierHubs.nearest(hub.latitude, hub.longitude, [](int) { return true; });
+            if (closest > 0) highways.emplace_back(closest, townHub[t]);
+            earlierHubs.insert(townHub[t], hub.latitude, hub.longitude);
+        }
+        std::sort(highways.begin(), highways.end());
+        highways.erase(std::unique(highways.begin(), highways.end()), highways.end());
+        for (const auto& pair : highways) addRoute(net, pair.first, pair.second, 3000, 6000, 1.0, highway);
+    }
+
+    // Central stock and thresholds as in the demo network, plus some stock at a share of the sites
+    void addStock(TransportationNetwork& net, ResourceManager& rm) {
+        const int k = std::max(1, options.stockScale);
+        rm.addResource(Resource("Medical Kits", 1000 * k, 365, 50.0, 2.5, 200 * k));
+        rm.addResource(Resource("Water", 5000 * k, 90, 2.0, 1.0, 1000 * k));
+        rm.addResource(Resource("Emergency Food", 3000 * k, 180, 8.0, 0.75, 500 * k));
+        rm.addResource(Resource("Blankets", 800 * k, 0, 15.0, 1.5, 100 * k));
+        rm.addResource(Resource("Medicines", 500 * k, 240, 100.0, 0.5, 100 * k));
+
+        for (int id = 2; id <= options.locations; ++id) {
+            if (uniform(0, 1) >= options.stockedShare) continue;
+            Location* site = net.getLocation(id);
+            site->addResource(resourceTypes[uniformInt(0, static_cast<int>(resourceTypes.size()) - 1)], uniformInt(100, 500) * k);
+        }
+    }
+
+public:
+    explicit WorkloadGenerator(const WorkloadOptions& opts = WorkloadOptions())
+        : options(opts), rng(opts.seed) {
+        options.locations = std::max(1, options.locations);
+        resourceTypes = {
+            internResourceType("Medical Kits"), internResourceType("Water"), internResourceType("Emergency Food"),
+            internResourceType("Blankets"), internResourceType("Medicines")
+        };
+    }
+
+    const WorkloadOptions& settings() const { return options; }
+
+    /*
+        Fills an empty network and resource manager. Calling it again on fresh
+        objects builds the same network, so benchmarks can rebuild one that
+        earlier iterations have loaded up.
+    */
+    void build(TransportationNetwork& net, ResourceManager& rm) {
+        rng.seed(options.seed);
+        routes.clear();
+        net.reserve(static_cast<size_t>(options.locations), 0);
+        switch (options.shape) {
+        case NetworkShape::GRID: buildGrid(net); break;
+        case NetworkShape::RANDOM_GEOMETRIC: buildRandomGeometric(net); break;
+        case NetworkShape::ROAD_LIKE: buildRoadLike(net); break;
+        }
+        net.addRoutes(routes);
+        addStock(net, rm);
+        routes.clear();
+        routes.shrink_to_fit();
+    }
+
+    /*
+        `count` requests from the warehouse to uniformly chosen sites, with the
+        quantity and priority ranges of the simulation's daily requests.
+        IDs start at nextRequestId, which is advanced past them.
+    */
+    std::vector<Request> requests(size_t count, int& nextRequestId) {
+        std::vector<Request> out;
+        if (options.locations < 2) return out;
+        out.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            ResourceTypeId type = resourceTypes[uniformInt(0, static_cast<int>(resourceTypes.size()) - 1)];
+            out.emplace_back(nextRequestId++, 1, uniformInt(2, options.locations), type,
+                uniformInt(50, 500), uniformInt(3, 10));
+        }
+        return out;
+    }
+
+    // A uniformly chosen location ID
+    int randomLocation() { return uniformInt(1, options.locations); }
+};
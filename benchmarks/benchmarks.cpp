@@ -0,0 +1,512 @@
+/*
+    Microbenchmarks for the hot paths of the planner, on synthetic networks from
+    WorkloadGenerator (grid, random geometric and road-like, up to 100k sites).
+
+    Build from the repository root:
+        g++ -std=c++17 -O2 -pthread -IHeaders benchmarks/benchmarks.cpp -o rrp_bench
+
+    Run:
+        ./rrp_bench                             all benchmarks
+        ./rrp_bench --filter path/              only names containing "path/"
+        ./rrp_bench --min-time 1.0              measure each one for at least a second
+        ./rrp_bench --save before.txt           keep the results ...
+        ./rrp_bench --baseline before.txt       ... and compare a later run against them; exits
+                                                with 1 if anything got slower than --tolerance
+                                                (default 0.10 = 10%)
+        ./rrp_bench --generate road 100000 network.img
+                                                write a synthetic network for the simulator's --image
+
+    Each benchmark is run with a growing iteration count until one run takes
+    --min-time; setup done before the timed loop (or between pauseTiming and
+    resumeTiming) is not counted.
+*/
+
+#include "WorkloadGenerator.h"
+#include "ResourceAllocationSimulation.h"
+#include "NetworkImage.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Results written here can't be optimized away
+volatile size_t resultSink = 0;
+
+/*
+    Timing state of one run of a benchmark, used like Google Benchmark's:
+        while (state.keepRunning()) { ...one operation... }
+*/
+class BenchmarkState {
+    size_t remaining;
+    size_t total;
+    bool started = false;
+    Clock::time_point runningSince;
+    Clock::duration measured{ 0 };
+    long long items = 0;
+
+public:
+    explicit BenchmarkState(size_t iterations) : remaining(iterations), total(iterations) {}
+
+    bool keepRunning() {
+        if (!started) {
+            started = true;
+            runningSince = Clock::now();
+        }
+        if (remaining > 0) {
+            --remaining;
+            return true;
+        }
+        measured += Clock::now() - runningSince;
+        return false;
+    }
+
+    void pauseTiming() { measured += Clock::now() - runningSince; }
+    void resumeTiming() { runningSince = Clock::now(); }
+
+    // Units of work done in the whole run (requests, records, ...), for a throughput column
+    void setItemsProcessed(long long count) { items = count; }
+
+    size_t iterations() const { return total; }
+    size_t iteration() const { return total - remaining; }   // 1-based inside the loop
+    double seconds() const { return std::chrono::duration<double>(measured).count(); }
+    long long itemsProcessed() const { return items; }
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<void(BenchmarkState&)> run;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations = 0;
+    double nsPerOp = 0;
+    double itemsPerSecond = 0;
+};
+
+std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+void addBenchmark(const std::string& name, std::function<void(BenchmarkState&)> run) {
+    registry().push_back({ name, std::move(run) });
+}
+
+// Runs with 1, then more and more iterations until a run lasts minSeconds
+BenchmarkResult measure(const Benchmark& b, double minSeconds) {
+    size_t iterations = 1;
+    while (true) {
+        BenchmarkState state(iterations);
+        b.run(state);
+        double seconds = state.seconds();
+        if (seconds >= minSeconds || iterations >= 1000000000) {
+            BenchmarkResult r;
+            r.name = b.name;
+            r.iterations = iterations;
+            r.nsPerOp = seconds * 1e9 / iterations;
+            r.itemsPerSecond = state.itemsProcessed() > 0 && seconds > 0 ? state.itemsProcessed() / seconds : 0;
+            return r;
+        }
+        double grow = seconds > 0 ? 1.4 * minSeconds / seconds : 100.0;
+        iterations = std::max(iterations + 1, static_cast<size_t>(iterations * std::min(100.0, grow)));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Fixtures: networks are built once per (shape, size) and shared by the
+// read-only benchmarks
+
+struct NetworkFixture {
+    TransportationNetwork network;
+    ResourceManager resources{ network };
+    std::vector<std::pair<int, int>> pairs;   // random (source, target) queries
+};
+
+WorkloadOptions workload(NetworkShape shape, int locations) {
+    WorkloadOptions options;
+    options.shape = shape;
+    options.locations = locations;
+    options.regionKm = 50.0 * std::sqrt(locations / 1000.0);   // same density at every size
+    options.stockScale = 1000;
+    return options;
+}
+
+void buildFixture(NetworkFixture& f, NetworkShape shape, int locations) {
+    WorkloadGenerator generator(workload(shape, locations));
+    f.network.seedRandom(1);
+    generator.build(f.network, f.resources);
+    f.pairs.clear();
+    for (int i = 0; i < 1024; ++i) f.pairs.emplace_back(generator.randomLocation(), generator.randomLocation());
+    std::vector<int> path;
+    f.network.findOptimalPath(1, 1, 1, path);   // builds the CSR arrays outside the timed loop
+}
+
+NetworkFixture& sharedFixture(NetworkShape shape, int locations) {
+    static std::map<std::pair<int, int>, std::unique_ptr<NetworkFixture>> cache;
+    auto& slot = cache[{ static_cast<int>(shape), locations }];
+    if (!slot) {
+        slot.reset(new NetworkFixture);
+        buildFixture(*slot, shape, locations);
+    }
+    return *slot;
+}
+
+std::string temporaryFile(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// ---------------------------------------------------------------------------
+// Benchmarks
+
+void registerPathBenchmarks() {
+    for (NetworkShape shape : { NetworkShape::GRID, NetworkShape::RANDOM_GEOMETRIC, NetworkShape::ROAD_LIKE }) {
+        for (int locations : { 1000, 10000, 100000 }) {
+            std::string suffix = std::string(networkShapeName(shape)) + "/" + std::to_string(locations);
+            addBenchmark("path/findOptimalPath/" + suffix, [shape, locations](BenchmarkState& state) {
+                const NetworkFixture& f = sharedFixture(shape, locations);
+                std::vector<int> path;
+                size_t found = 0;
+                while (state.keepRunning()) {
+                    const auto& q = f.pairs[state.iteration() % f.pairs.size()];
+                    found += f.network.findOptimalPath(q.first, q.second, 100, path);
+                }
+                resultSink = resultSink + found;
+            });
+        }
+        std::string suffix = std::string(networkShapeName(shape)) + "/10000";
+        addBenchmark("path/findCachedPath/" + suffix, [shape](BenchmarkState& state) {
+            const NetworkFixture& f = sharedFixture(shape, 10000);
+            std::vector<int> path;
+            size_t found = 0;
+            while (state.keepRunning()) {
+                // Requests leave from the warehouse, so its shortest-path tree stays cached
+                int target = f.pairs[state.iteration() % f.pairs.size()].second;
+                found += f.network.findCachedPath(1, target, 100, path);
+            }
+            resultSink = resultSink + found;
+        });
+    }
+}
+
+void registerQueueBenchmarks() {
+    const size_t queueSize = 100000;
+    WorkloadGenerator generator(workload(NetworkShape::GRID, 1000));
+    int nextId = 1;
+    auto backlog = std::make_shared<std::vector<Request>>(generator.requests(queueSize, nextId));
+    auto extra = std::make_shared<std::vector<Request>>(generator.requests(65536, nextId));
+
+    // One addRequest into a queue of 100k; the queue is reset every 64k adds
+    addBenchmark("queue/addRequest/100000", [backlog, extra](BenchmarkState& state) {
+        std::unique_ptr<PriorityRequestQueue> queue(new PriorityRequestQueue);
+        queue->addRequests(*backlog);
+        size_t next = 0;
+        while (state.keepRunning()) {
+            if (next == extra->size()) {
+                state.pauseTiming();
+                queue.reset(new PriorityRequestQueue);
+                queue->addRequests(*backlog);
+                next = 0;
+                state.resumeTiming();
+            }
+            queue->addRequest((*extra)[next++]);
+        }
+    });
+
+    // getTopRequest + processTopRequest, refilled when empty
+    addBenchmark("queue/processTopRequest/100000", [backlog](BenchmarkState& state) {
+        PriorityRequestQueue queue;
+        queue.addRequests(*backlog);
+        long long ids = 0;
+        while (state.keepRunning()) {
+            if (queue.isEmpty()) {
+                state.pauseTiming();
+                queue.addRequests(*backlog);
+                state.resumeTiming();
+            }
+            ids += queue.getTopRequest().requestId;
+            queue.processTopRequest();
+        }
+        resultSink = resultSink + static_cast<size_t>(ids);
+    });
+
+    addBenchmark("queue/updateRequestPriority/100000", [backlog](BenchmarkState& state) {
+        PriorityRequestQueue queue;
+        queue.addRequests(*backlog);
+        std::mt19937 rng(5);
+        std::uniform_int_distribution<size_t> pick(0, backlog->size() - 1);
+        std::uniform_int_distribution<int> priority(1, 10);
+        while (state.keepRunning()) {
+            queue.updateRequestPriority((*backlog)[pick(rng)].requestId, priority(rng));
+        }
+    });
+
+    // Bulk load of a whole backlog (one heapify); items = requests
+    addBenchmark("queue/addRequests/100000", [backlog](BenchmarkState& state) {
+        while (state.keepRunning()) {
+            PriorityRequestQueue queue;
+            queue.addRequests(*backlog);
+            resultSink = resultSink + queue.isEmpty();
+        }
+        state.setItemsProcessed(static_cast<long long>(state.iterations() * backlog->size()));
+    });
+}
+
+void registerResourceBenchmarks() {
+    for (NetworkShape shape : { NetworkShape::GRID, NetworkShape::ROAD_LIKE }) {
+        std::string name = std::string("resources/transferResources/") + networkShapeName(shape) + "/10000";
+        addBenchmark(name, [shape](BenchmarkState& state) {
+            // Transfers leave their load on the routes, so the network is rebuilt
+            // (untimed) before it fills up
+            const size_t rebuildEvery = 512;
+            const ResourceTypeId water = internResourceType("Water");
+            std::unique_ptr<NetworkFixture> f;
+            auto rebuild = [&] {
+                f.reset(new NetworkFixture);
+                buildFixture(*f, shape, 10000);
+                f->network.getLocation(1)->addResource(water, 1000000000);
+            };
+            rebuild();
+            long long moved = 0;
+            while (state.keepRunning()) {
+                if (state.iteration() % rebuildEvery == 0) {
+                    state.pauseTiming();
+                    rebuild();
+                    state.resumeTiming();
+                }
+                int target = f->pairs[state.iteration() % f->pairs.size()].second;
+                moved += f->resources.transferResources(1, target, water, 10);
+            }
+            resultSink = resultSink + static_cast<size_t>(moved);
+        });
+    }
+
+    // One shipment leaves per tick and the clock moves on; items = hop events run
+    addBenchmark("resources/dispatchAllocation/road/10000", [](BenchmarkState& state) {
+        const ResourceTypeId water = internResourceType("Water");
+        NetworkFixture f;
+        buildFixture(f, NetworkShape::ROAD_LIKE, 10000);
+        f.resources.getResource(water)->addStock(1000000000);
+        ShipmentScheduler shipments(f.network);
+        while (state.keepRunning()) {
+            int target = f.pairs[state.iteration() % f.pairs.size()].second;
+            f.resources.dispatchAllocation(water, 10, 1, target, shipments);
+            shipments.advanceTo(shipments.now());
+        }
+        state.setItemsProcessed(shipments.stats().hops);
+        resultSink = resultSink + shipments.inTransit();
+    });
+}
+
+void registerLoggerBenchmarks() {
+    for (bool async : { false, true }) {
+        addBenchmark(std::string("logger/log/") + (async ? "async" : "sync"), [async](BenchmarkState& state) {
+            std::string file = temporaryFile("rrp_bench_log.txt");
+            std::remove(file.c_str());
+            {
+                EventLogger logger(file);
+                logger.setConsoleEcho(false);
+                if (async) logger.startAsync();
+                const std::string message = "Allocated 250 units of Medical Kits from Loc1 to Loc4817";
+                while (state.keepRunning()) {
+                    logger.log(message);
+                    // Draining the ring is part of the cost
+                    if (state.iteration() == state.iterations()) logger.stopAsync();
+                }
+            }
+            std::remove(file.c_str());
+            state.setItemsProcessed(static_cast<long long>(state.iterations()));
+        });
+    }
+}
+
+/*
+    Whole simulated days on a synthetic network loaded from an image, the way
+    a large deployment starts. One iteration is a run of `days` days with 100
+    new requests a day; items = requests handled.
+*/
+void registerSimulationBenchmarks() {
+    for (NetworkShape shape : { NetworkShape::GRID, NetworkShape::ROAD_LIKE }) {
+        std::string name = std::string("simulation/runSimulation/") + networkShapeName(shape) + "/10000";
+        addBenchmark(name, [shape](BenchmarkState& state) {
+            const int days = 10;
+            std::string image = temporaryFile(std::string("rrp_bench_") + networkShapeName(shape) + ".img");
+            {
+                NetworkFixture f;
+                buildFixture(f, shape, 10000);
+                if (!NetworkImage::write(image, f.network, f.resources)) throw std::runtime_error("Cannot write " + image);
+            }
+            SimulationConfig config;
+            config.consoleOutput = false;
+            config.writeReports = false;
+            config.logFile.clear();
+            config.networkImage = image;
+            config.requestsPerDay = 100;
+            config.seed = 42;
+
+            long long requests = 0;
+            while (state.keepRunning()) {
+                state.pauseTiming();
+                std::unique_ptr<ResourceAllocationSimulation> simulation(new ResourceAllocationSimulation(config));
+                state.resumeTiming();
+                simulation->runSimulation(days);
+                requests += simulation->stats().requestsHandled;
+            }
+            std::remove(image.c_str());
+            state.setItemsProcessed(requests);
+        });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Result files: one "name ns_per_op" line per benchmark
+
+void saveResults(const std::string& filename, const std::vector<BenchmarkResult>& results) {
+    std::ofstream out(filename);
+    if (!out) throw std::runtime_error("Cannot write " + filename);
+    for (const BenchmarkResult& r : results) out << r.name << " " << std::setprecision(6) << r.nsPerOp << "\n";
+}
+
+std::map<std::string, double> loadResults(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in) throw std::runtime_error("Cannot read " + filename);
+    std::map<std::string, double> results;
+    std::string name;
+    double ns = 0;
+    while (in >> name >> ns) results[name] = ns;
+    return results;
+}
+
+std::string formatRate(double perSecond) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (perSecond >= 1e6) out << perSecond / 1e6 << "M/s";
+    else if (perSecond >= 1e3) out << perSecond / 1e3 << "k/s";
+    else out << perSecond << "/s";
+    return out.str();
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--filter TEXT] [--min-time SECONDS] [--save FILE]\n"
+        << "       [--baseline FILE] [--tolerance FRACTION] [--list]\n"
+        << "       " << program << " --generate grid|geometric|road LOCATIONS FILE\n";
+}
+
+// Writes a synthetic network image for the simulator (--image FILE)
+int generateImage(const std::string& shapeName, const std::string& count, const std::string& filename) {
+    NetworkShape shape;
+    if (!parseNetworkShape(shapeName, shape)) throw std::invalid_argument("Unknown network shape: " + shapeName);
+    int locations = std::stoi(count);
+    if (locations < 2) throw std::invalid_argument("Need at least 2 locations");
+    NetworkFixture f;
+    buildFixture(f, shape, locations);
+    if (!NetworkImage::write(filename, f.network, f.resources)) throw std::runtime_error("Cannot write " + filename);
+    std::cout << "Wrote " << filename << ": " << f.network.getLocations().size() << " locations, "
+        << f.network.edgeCount() / 2 << " routes\n";
+    return 0;
+}
+
+int run(int argc, char* argv[]) {
+    std::string filter, saveFile, baselineFile;
+    double minSeconds = 0.5;
+    double tolerance = 0.10;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--filter") filter = value();
+        else if (arg == "--min-time") minSeconds = std::stod(value());
+        else if (arg == "--save") saveFile = value();
+        else if (arg == "--baseline") baselineFile = value();
+        else if (arg == "--tolerance") tolerance = std::stod(value());
+        else if (arg == "--list") listOnly = true;
+        else if (arg == "--generate") {
+            if (i + 3 >= argc) throw std::invalid_argument("--generate needs SHAPE LOCATIONS FILE");
+            return generateImage(argv[i + 1], argv[i + 2], argv[i + 3]);
+        }
+        else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else throw std::invalid_argument("Unknown option: " + arg);
+    }
+
+    registerPathBenchmarks();
+    registerQueueBenchmarks();
+    registerResourceBenchmarks();
+    registerLoggerBenchmarks();
+    registerSimulationBenchmarks();
+
+    std::map<std::string, double> baseline;
+    if (!baselineFile.empty()) baseline = loadResults(baselineFile);
+
+    std::cout << std::left << std::setw(48) << "benchmark" << std::right << std::setw(12) << "iterations"
+        << std::setw(16) << "ns/op" << std::setw(12) << "items" << std::setw(12) << "change" << "\n";
+    std::vector<BenchmarkResult> results;
+    int regressions = 0;
+    for (const Benchmark& b : registry()) {
+        if (!filter.empty() && b.name.find(filter) == std::string::npos) continue;
+        if (listOnly) {
+            std::cout << b.name << "\n";
+            continue;
+        }
+        BenchmarkResult r = measure(b, minSeconds);
+        results.push_back(r);
+
+        std::cout << std::left << std::setw(48) << r.name << std::right << std::setw(12) << r.iterations
+            << std::setw(16) << std::fixed << std::setprecision(1) << r.nsPerOp
+            << std::setw(12) << (r.itemsPerSecond > 0 ? formatRate(r.itemsPerSecond) : "");
+        auto old = baseline.find(r.name);
+        if (old != baseline.end() && old->second > 0) {
+            double change = r.nsPerOp / old->second - 1.0;
+            std::ostringstream text;
+            text << std::showpos << std::fixed << std::setprecision(1) << change * 100 << "%";
+            std::cout << std::setw(12) << text.str();
+            if (change > tolerance) {
+                std::cout << "  REGRESSION";
+                ++regressions;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!saveFile.empty()) saveResults(saveFile, results);
+    if (regressions > 0) {
+        std::cout << regressions << " benchmark(s) slower than the baseline by more than "
+            << tolerance * 100 << "%\n";
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        return run(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+}
@@ -1,38 +1,216 @@
 #include "ResourceAllocationSimulation.h"
+#include "ScenarioRunner.h"
 
 #include <iostream>
-#include <ctime>
 #include <limits>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+#include <random>
 
-int main() {
+namespace {
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--days N] [--seed S] [--scale K] [--log FILE] [--reports] [--metrics FILE]\n"
+        << "       [--image FILE] [--save-image FILE] [--requests-csv FILE] [--transit]\n"
+        << "       [--scenarios N [--threads T]]\n"
+        << "  Without arguments the simulation runs interactively (1-10 days).\n"
+        << "  With arguments it runs headless: no console output while it runs,\n"
+        << "  only a metrics summary at the end.\n"
+        << "  --days N    days to simulate (default 365)\n"
+        << "  --seed S    seed for a reproducible run (default: random, printed at the end)\n"
+        << "  --scale K   multiplies daily requests and initial stock (default 1)\n"
+        << "  --log FILE  write the event log to FILE (default: no log)\n"
+        << "  --reports   also write the day_N / final report files\n"
+        << "  --metrics FILE  write hot-path metrics at the end (JSON for *.json, else Prometheus\n"
+        << "                  text); build with -DRRP_METRICS to collect them\n"
+        << "  --image FILE       start from a saved network image instead of the demo network\n"
+        << "  --save-image FILE  save the initial network and inventory as an image, then run\n"
+        << "  --requests-csv FILE  queue the requests of a CSV export (source,target,resource,\n"
+        << "                       quantity,priority[,id]) before the first day\n"
+        << "  --transit   shipments travel in simulated minutes and hold their route load\n"
+        << "              until they arrive, instead of being delivered at once\n"
+        << "  --scenarios N  run N independent scenarios in parallel (seeds derived from --seed)\n"
+        << "                 and print the distribution of their outcomes; no log or reports\n"
+        << "  --threads T    worker threads for --scenarios (default: one per core)\n";
+}
+
+// Parses the value following option `name`; throws on a missing or malformed number
+long long numberArgument(int argc, char* argv[], int& i, const char* name, long long min, long long max) {
+    if (i + 1 >= argc) throw std::invalid_argument(std::string(name) + " needs a value");
+    const char* text = argv[++i];
+    size_t used = 0;
+    long long value = 0;
     try {
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
-        std::cout << "=== Resource Allocation System Simulation ===\n";
-        std::cout << "Initializing simulation...\n";
-
-        ResourceAllocationSimulation simulation;
-
-        int days = 0;
-        while (true) {
-            std::cout << "Enter number of days to simulate (1-10): ";
-            if (!(std::cin >> days)) {
-                std::cout << "Invalid input. Please enter a number between 1 and 10.\n";
-                std::cin.clear();
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-                continue;
-            }
-            if (days < 1 || days > 10) {
-                std::cout << "Please enter a number between 1 and 10.\n";
-                continue;
-            }
-            break;
-        }
-
-        simulation.runSimulation(days);
+        value = std::stoll(text, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;   // reported below
+    }
+    if (used == 0 || text[used] != '\0' || value < min || value > max) {
+        throw std::invalid_argument(std::string("Invalid value for ") + name + ": " + text);
+    }
+    return value;
+}
+
+int runInteractive() {
+    std::cout << "=== Resource Allocation System Simulation ===\n";
+    std::cout << "Initializing simulation...\n";
+
+    ResourceAllocationSimulation simulation;
+
+    int days = 0;
+    while (true) {
+        std::cout << "Enter number of days to simulate (1-10): ";
+        if (!(std::cin >> days)) {
+            std::cout << "Invalid input. Please enter a number between 1 and 10.\n";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            continue;
+        }
+        if (days < 1 || days > 10) {
+            std::cout << "Please enter a number between 1 and 10.\n";
+            continue;
+        }
+        break;
+    }
+
+    simulation.runSimulation(days);
+    return 0;
+}
+
+// Runs `scenarios` seeded variations of `config` on `threads` workers and prints their distribution
+int runScenarios(const SimulationConfig& config, int days, int scenarios, int threads) {
+    ScenarioRunOptions options;
+    options.scenarios = scenarios;
+    options.days = days;
+    options.base = config;
+    options.baseSeed = config.seed;
+    if (options.baseSeed == 0) {
+        std::random_device rd;
+        options.baseSeed = ((static_cast<std::uint64_t>(rd()) << 32) | rd()) | 1;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    ScenarioRunner runner(static_cast<size_t>(threads));
+    ScenarioSummary summary = runner.run(options);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::cout << "base_seed=" << options.baseSeed << "\n"
+        << "scenarios=" << scenarios << "\n"
+        << "threads=" << runner.threadCount() << "\n"
+        << "days=" << days << "\n";
+    summary.print(std::cout);
+    std::cout << "elapsed_seconds=" << seconds << "\n";
+
+    if (!config.metricsFile.empty() &&
+        !metrics::writeSnapshot(config.metricsFile, metrics::MetricsRegistry::instance().snapshot())) {
+        std::cerr << "Error: could not write metrics to " << config.metricsFile << "\n";
+    }
+    return summary.completed == scenarios ? 0 : 1;
+}
+
+int runHeadless(int argc, char* argv[]) {
+    SimulationConfig config;
+    config.consoleOutput = false;
+    config.writeReports = false;
+    config.logFile.clear();
+    int days = 365;
+    std::string saveImage;
+    int scenarios = 0;
+    int threads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--days") == 0) days = static_cast<int>(numberArgument(argc, argv, i, "--days", 1, 100000000));
+        else if (std::strcmp(argv[i], "--seed") == 0) config.seed = static_cast<std::uint64_t>(numberArgument(argc, argv, i, "--seed", 1, std::numeric_limits<long long>::max()));
+        else if (std::strcmp(argv[i], "--scale") == 0) config.scale = static_cast<int>(numberArgument(argc, argv, i, "--scale", 1, 100000));
+        else if (std::strcmp(argv[i], "--log") == 0) {
+            if (i + 1 >= argc) throw std::invalid_argument("--log needs a file name");
+            config.logFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--reports") == 0) config.writeReports = true;
+        else if (std::strcmp(argv[i], "--transit") == 0) config.shipmentsInTransit = true;
+        else if (std::strcmp(argv[i], "--scenarios") == 0) scenarios = static_cast<int>(numberArgument(argc, argv, i, "--scenarios", 1, 1000000));
+        else if (std::strcmp(argv[i], "--threads") == 0) threads = static_cast<int>(numberArgument(argc, argv, i, "--threads", 0, 4096));
+        else if (std::strcmp(argv[i], "--metrics") == 0) {
+            if (i + 1 >= argc) throw std::invalid_argument("--metrics needs a file name");
+            config.metricsFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--image") == 0) {
+            if (i + 1 >= argc) throw std::invalid_argument("--image needs a file name");
+            config.networkImage = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--save-image") == 0) {
+            if (i + 1 >= argc) throw std::invalid_argument("--save-image needs a file name");
+            saveImage = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--requests-csv") == 0) {
+            if (i + 1 >= argc) throw std::invalid_argument("--requests-csv needs a file name");
+            config.requestsCsv = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else throw std::invalid_argument(std::string("Unknown option: ") + argv[i]);
+    }
+
+    if (scenarios > 0) {
+        if (!config.logFile.empty() || config.writeReports || !saveImage.empty()) {
+            throw std::invalid_argument("--scenarios cannot be combined with --log, --reports or --save-image");
+        }
+        return runScenarios(config, days, scenarios, threads);
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    ResourceAllocationSimulation simulation(config);
+    if (!saveImage.empty() && !simulation.saveNetworkImage(saveImage)) {
+        throw std::runtime_error("Cannot write network image '" + saveImage + "'");
+    }
+    simulation.runSimulation(days);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    // One key=value per line, easy to grep or parse
+    const SimulationStats& s = simulation.stats();
+    std::cout << "seed=" << simulation.seed() << "\n"
+        << "days=" << s.days << "\n"
+        << "scale=" << config.scale << "\n"
+        << "requests=" << s.requestsHandled << "\n"
+        << "fulfilled=" << s.fulfilled << "\n"
+        << "partially_fulfilled=" << s.partiallyFulfilled << "\n"
+        << "rejected_offline=" << s.rejectedOffline << "\n"
+        << "rejected_no_route=" << s.rejectedNoRoute << "\n"
+        << "rejected_no_stock=" << s.rejectedNoStock << "\n"
+        << "shipped_from_local_stock=" << s.shippedFromLocalStock << "\n"
+        << "fulfillment_rate=" << s.fulfillmentRate() << "\n"
+        << "units_requested=" << s.unitsRequested << "\n"
+        << "units_delivered=" << s.unitsDelivered << "\n"
+        << "delivery_rate=" << s.deliveryRate() << "\n";
+    if (config.shipmentsInTransit) {
+        std::cout << "shipments_delivered=" << s.shipmentsDelivered << "\n"
+            << "shipments_in_transit=" << s.shipmentsInTransit << "\n";
+    }
+    std::cout
+        << "critical_resource_days=" << s.criticalResourceDays << "\n"
+        << "disaster_events=" << s.disruptions.events << "\n"
+        << "route_disruptions=" << s.disruptions.routeDisruptions << "\n"
+        << "location_disruptions=" << s.disruptions.locationDisruptions << "\n"
+        << "shortage_events=" << s.disruptions.shortageEvents << "\n"
+        << "units_lost=" << s.disruptions.unitsLost << "\n"
+        << "elapsed_seconds=" << seconds << "\n"
+        << "requests_per_second=" << (seconds > 0 ? s.requestsHandled / seconds : 0.0) << "\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        return argc > 1 ? runHeadless(argc, argv) : runInteractive();
     }
     catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-    return 0;
 }